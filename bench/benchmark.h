@@ -0,0 +1,124 @@
+#ifndef HLK_EVENTS_BENCHMARK_H
+#define HLK_EVENTS_BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ * Allocation counter. Replaces global operator new/delete, so this header
+ * must be included by exactly one translation unit of a benchmark executable.
+ * Every block is prefixed with its size to track the live heap bytes
+ *****************************************************************************/
+
+inline std::atomic<std::size_t> g_allocations { 0 };
+inline std::atomic<std::ptrdiff_t> g_liveBytes { 0 };
+
+constexpr std::size_t g_blockHeader = alignof(std::max_align_t);
+
+void *operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_liveBytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto block = static_cast<char *>(std::malloc(size + g_blockHeader))) {
+        std::memcpy(block, &size, sizeof(size));
+        return block + g_blockHeader;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto block = static_cast<char *>(ptr) - g_blockHeader;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    g_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+
+namespace Bench {
+
+struct Result {
+    std::string name;
+    double value;
+    std::string unit;
+};
+
+inline std::vector<Result> g_results;
+inline bool g_json = false;
+
+inline std::size_t allocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+inline std::ptrdiff_t liveBytes() {
+    return g_liveBytes.load(std::memory_order_relaxed);
+}
+
+// Prevents the optimizer from discarding a computed value
+template<class T>
+inline void doNotOptimize(T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Returns nanoseconds spent in a single call of func
+template<class TFunc>
+double ns(TFunc &&func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+// Returns average nanoseconds per call of func over the given iterations
+template<class TFunc>
+double nsPerOp(std::size_t iterations, TFunc &&func) {
+    return ns([&] () {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            func();
+        }
+    }) / iterations;
+}
+
+// Returns average heap allocations per call of func over the given iterations
+template<class TFunc>
+double allocsPerOp(std::size_t iterations, TFunc &&func) {
+    std::size_t begin = allocations();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        func();
+    }
+    return double(allocations() - begin) / iterations;
+}
+
+// Prints the result as a text line, or keeps it for printJson() in JSON mode
+inline void report(const std::string &name, double value, const char *unit) {
+    if (g_json) {
+        g_results.push_back({ name, value, unit });
+        return;
+    }
+    std::printf("%-48s %12.2f %s\n", name.c_str(), value, unit);
+}
+
+inline void printJson(const char *library, const char *version, const char *libraryType) {
+    std::printf("{\n  \"library\": \"%s\",\n  \"version\": \"%s\",\n  \"libraryType\": \"%s\",\n"
+        "  \"results\": [\n", library, version, libraryType);
+    for (std::size_t i = 0; i < g_results.size(); ++i) {
+        const Result &result = g_results[i];
+        std::printf("    { \"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\" }%s\n", result.name.c_str(),
+            result.value, result.unit.c_str(), i + 1 < g_results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+} // namespace Bench
+
+#endif // HLK_EVENTS_BENCHMARK_H
@@ -0,0 +1,588 @@
+#include "benchmark.h"
+
+#include <hlk/events/concurrentevent.h>
+#include <hlk/events/event.h>
+#include <hlk/events/eventbus.h>
+#include <hlk/events/eventloop.h>
+#include <hlk/events/eventqueue.h>
+#include <hlk/events/keyedevent.h>
+#include <hlk/events/notifiableobject.h>
+#include <hlk/events/staticevent.h>
+#include <hlk/events/threadingpolicy.h>
+
+#include <array>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef HLK_EVENTS_VERSION
+#define HLK_EVENTS_VERSION "unknown"
+#endif
+
+#ifndef HLK_EVENTS_LIBRARY_TYPE
+#define HLK_EVENTS_LIBRARY_TYPE "unknown"
+#endif
+
+using namespace Hlk;
+
+static int g_sink = 0;
+
+/******************************************************************************
+ * Handlers. Equal handlers are attached only once, so every kind provides
+ * maxHandlers distinct ones
+ *****************************************************************************/
+
+constexpr std::size_t maxHandlers = 1024;
+
+template<int I>
+void function(int value) { g_sink += value + I; }
+
+template<int... Is>
+constexpr std::array<void (*)(int), sizeof...(Is)> makeFunctions(std::integer_sequence<int, Is...>) {
+    return { &function<Is>... };
+}
+
+static constexpr auto g_functions = makeFunctions(std::make_integer_sequence<int, maxHandlers>());
+
+class Handler : public NotifiableObject {
+public:
+    void method(int value) { g_sink += value; }
+};
+
+static auto makeLambda(std::size_t index) {
+    return [index] (int value) { g_sink += value + int(index); };
+}
+
+enum class Kind { Function, Method, Lambda };
+
+static const char *kindName(Kind kind) {
+    switch (kind) {
+    case Kind::Function: return "function";
+    case Kind::Method: return "method";
+    default: return "lambda";
+    }
+}
+
+template<class TEvent>
+static Connection subscribe(TEvent &event, Kind kind, std::size_t index, Handler *handlers) {
+    switch (kind) {
+    case Kind::Function: return event.addEventHandler(g_functions[index]);
+    case Kind::Method: return event.addEventHandler(&handlers[index], &Handler::method);
+    default: return event.addEventHandler(makeLambda(index));
+    }
+}
+
+template<class TEvent>
+static void unsubscribeByValue(TEvent &event, Kind kind, std::size_t index, Handler *handlers) {
+    switch (kind) {
+    case Kind::Function: event.removeEventHandler(g_functions[index]); break;
+    case Kind::Method: event.removeEventHandler(&handlers[index], &Handler::method); break;
+    default: event.removeEventHandler(makeLambda(index)); break;
+    }
+}
+
+static std::string name(const char *operation, Kind kind, std::size_t count) {
+    return std::string(operation) + "/" + kindName(kind) + "/" + std::to_string(count);
+}
+
+/******************************************************************************
+ * Benchmarks
+ *****************************************************************************/
+
+static void footprint(Handler *handlers) {
+    Bench::report("sizeof/Event", sizeof(Event<int>), "bytes");
+    Bench::report("sizeof/ConcurrentEvent", sizeof(ConcurrentEvent<int>), "bytes");
+    Bench::report("sizeof/Delegate", sizeof(Delegate<void(int)>), "bytes");
+    Bench::report("sizeof/NotifiableObject", sizeof(NotifiableObject), "bytes");
+
+    // Heap owned by an empty event besides the event object itself
+    constexpr std::size_t events = 1000;
+    std::vector<std::unique_ptr<Event<int>>> eventList;
+    eventList.reserve(events);
+    std::ptrdiff_t before = Bench::liveBytes();
+    for (std::size_t i = 0; i < events; ++i) {
+        eventList.push_back(std::make_unique<Event<int>>());
+    }
+    Bench::report("heap/Event", double(Bench::liveBytes() - before) / events - sizeof(Event<int>), "bytes");
+
+    // State block allocated by the first subscription, with its handler
+    before = Bench::liveBytes();
+    for (auto &event : eventList) {
+        event->addEventHandler(&handlers[0], &Handler::method);
+    }
+    Bench::report("heap/Event/subscribed", double(Bench::liveBytes() - before) / events, "bytes");
+
+    // Heap per subscription, amortized over a full event
+    for (Kind kind : { Kind::Function, Kind::Method, Kind::Lambda }) {
+        Event<int> event;
+        before = Bench::liveBytes();
+        for (std::size_t i = 0; i < maxHandlers; ++i) {
+            subscribe(event, kind, i, handlers);
+        }
+        Bench::report(std::string("heap/subscription/") + kindName(kind),
+            double(Bench::liveBytes() - before) / maxHandlers, "bytes");
+    }
+}
+
+static void allocations(Handler *handlers) {
+    constexpr std::size_t iterations = 100000;
+    int captured = 1;
+
+    double eventAllocs = Bench::allocsPerOp(iterations, [] () {
+        Event<int> event;
+    });
+    Bench::report("alloc/construct/Event", eventAllocs, "allocs");
+
+    // Allocations per subscription on a fresh event, excluding the event's own
+    for (Kind kind : { Kind::Function, Kind::Method, Kind::Lambda }) {
+        Bench::report(std::string("alloc/subscribe/") + kindName(kind), Bench::allocsPerOp(iterations, [&] () {
+            Event<int> event;
+            subscribe(event, kind, 0, handlers);
+        }) - eventAllocs, "allocs");
+    }
+
+    Bench::report("alloc/bind/lambda", Bench::allocsPerOp(iterations, [&] () {
+        Delegate<void(int)> delegate;
+        delegate.bind([&captured] (int value) { g_sink += value + captured; });
+    }), "allocs");
+
+    Event<int> event;
+    for (std::size_t i = 0; i < 8; ++i) {
+        subscribe(event, Kind::Method, i, handlers);
+    }
+    Bench::report("alloc/emit/method/8", Bench::allocsPerOp(iterations, [&] () {
+        event(1);
+    }), "allocs");
+}
+
+static void invocation(Handler *handlers) {
+    constexpr std::size_t iterations = 10000000;
+    int captured = 1;
+
+    Delegate<void(int)> functionDelegate(g_functions[0]);
+    Bench::report("invoke/delegate/function", Bench::nsPerOp(iterations, [&] () {
+        functionDelegate(1);
+    }), "ns");
+    Delegate<void(int)> methodDelegate(&handlers[0], &Handler::method);
+    Bench::report("invoke/delegate/method", Bench::nsPerOp(iterations, [&] () {
+        methodDelegate(1);
+    }), "ns");
+    Delegate<void(int)> lambdaDelegate;
+    lambdaDelegate.bind([&captured] (int value) { g_sink += value + captured; });
+    Bench::report("invoke/delegate/lambda", Bench::nsPerOp(iterations, [&] () {
+        lambdaDelegate(1);
+    }), "ns");
+
+    Bench::report("emit/static/method/1", Bench::nsPerOp(iterations, [&] () {
+        StaticEvent<&Handler::method>::emit(&handlers[0], 1);
+    }), "ns");
+}
+
+static void emission(Handler *handlers) {
+    for (std::size_t count : { 0, 1, 8, 64, 1024 }) {
+        std::size_t iterations = 10000000 / (count ? count : 1);
+        for (Kind kind : { Kind::Function, Kind::Method, Kind::Lambda }) {
+            Event<int> event;
+            for (std::size_t i = 0; i < count; ++i) {
+                subscribe(event, kind, i, handlers);
+            }
+            Bench::report(name("emit", kind, count), Bench::nsPerOp(iterations, [&] () {
+                event(1);
+            }), "ns");
+        }
+
+        std::vector<std::shared_ptr<Handler>> shared;
+        Event<int> weakEvent;
+        for (std::size_t i = 0; i < count; ++i) {
+            shared.push_back(std::make_shared<Handler>());
+            weakEvent.addEventHandler(std::weak_ptr<Handler>(shared.back()), &Handler::method);
+        }
+        Bench::report("emit/weak-method/" + std::to_string(count), Bench::nsPerOp(iterations, [&] () {
+            weakEvent(1);
+        }), "ns");
+
+        ConcurrentEvent<int> concurrentEvent;
+        for (std::size_t i = 0; i < count; ++i) {
+            subscribe(concurrentEvent, Kind::Lambda, i, handlers);
+        }
+        Bench::report("emit/concurrent/lambda/" + std::to_string(count), Bench::nsPerOp(iterations, [&] () {
+            concurrentEvent(1);
+        }), "ns");
+    }
+}
+
+template<class TPolicy>
+static void policy(const std::string &policyName) {
+    // Emission and lifetime cost of the lock and the object tracking
+    for (std::size_t count : { 1, 8 }) {
+        Event<TPolicy, int> event;
+        for (std::size_t i = 0; i < count; ++i) {
+            event.addEventHandler(makeLambda(i));
+        }
+        Bench::report("emit/policy/" + policyName + "/" + std::to_string(count), Bench::nsPerOp(10000000, [&] () {
+            event(1);
+        }), "ns");
+    }
+
+    Handler handler;
+    Bench::report("lifetime/policy/" + policyName + "+method", Bench::nsPerOp(1000000, [&] () {
+        Event<TPolicy, int> event;
+        event.addEventHandler(&handler, &Handler::method);
+    }), "ns");
+}
+
+static void policies() {
+    policy<MultiThreaded>("multi-threaded");
+    policy<FutexLocked>("futex");
+    policy<SpinLocked>("spin");
+    policy<SingleThreaded>("single-threaded");
+    policy<SingleThreadedUntracked>("untracked");
+}
+
+static void results() {
+    constexpr std::size_t checks = 40;
+    constexpr std::size_t iterations = 200000;
+
+    // Admission checks where the second of 40 handlers rejects
+    Event<bool(int)> event;
+    for (std::size_t i = 0; i < checks; ++i) {
+        event.addEventHandler([i] (int value) { return i != 1 && value >= 0; });
+    }
+    Bench::report("emit/result/last/40", Bench::nsPerOp(iterations, [&] () {
+        g_sink += event(1).value_or(false);
+    }), "ns");
+    Bench::report("emit/result/all-of/40", Bench::nsPerOp(iterations, [&] () {
+        g_sink += event.emit(AllOf(), 1);
+    }), "ns");
+}
+
+static void parallel() {
+    constexpr std::size_t handlers = 12;
+    constexpr std::size_t iterations = 2000;
+
+    // Independent CPU-heavy handlers, sequential vs. fanned out to the pool
+    Event<int> event;
+    for (std::size_t i = 0; i < handlers; ++i) {
+        event.addEventHandler([i] (int value) {
+            std::size_t hash = value + i;
+            for (int round = 0; round < 20000; ++round) {
+                hash = hash * 31 + round;
+            }
+            g_sink += hash & 1;
+        });
+    }
+    Bench::report("emit/heavy/12", Bench::nsPerOp(iterations, [&] () {
+        event(1);
+    }), "ns");
+    Bench::report("emit/parallel/heavy/12", Bench::nsPerOp(iterations, [&] () {
+        event.emitParallel(1);
+    }), "ns");
+
+    // Overhead of the fan-out with trivial handlers
+    Event<int> light;
+    for (std::size_t i = 0; i < 8; ++i) {
+        light.addEventHandler([i] (int value) { g_sink += value + int(i); });
+    }
+    Bench::report("emit/parallel/lambda/8", Bench::nsPerOp(100000, [&] () {
+        light.emitParallel(1);
+    }), "ns");
+}
+
+static void batches(Handler *handlers) {
+    constexpr std::size_t items = 1024;
+    constexpr std::size_t rounds = 1000;
+    std::vector<int> batch(items, 1);
+
+    // Per-item handlers, emitted item by item and as a batch
+    Event<int> event;
+    for (std::size_t i = 0; i < 8; ++i) {
+        subscribe(event, Kind::Lambda, i, handlers);
+    }
+    Bench::report("emit/items/lambda/8", Bench::nsPerOp(rounds, [&] () {
+        for (int item : batch) {
+            event(item);
+        }
+    }) / items, "ns");
+    Bench::report("emit/batch/lambda/8", Bench::nsPerOp(rounds, [&] () {
+        event.emitBatch(batch);
+    }) / items, "ns");
+
+    // A batch handler processing the whole span at once
+    Event<int> batchEvent;
+    batchEvent.addBatchHandler([] (Span<const int> values) {
+        for (int value : values) {
+            g_sink += value;
+        }
+    });
+    Bench::report("emit/batch/batch-handler/1", Bench::nsPerOp(rounds, [&] () {
+        batchEvent.emitBatch(batch);
+    }) / items, "ns");
+}
+
+static void queues(Handler *handlers) {
+    constexpr std::size_t items = 1024;
+    constexpr std::size_t rounds = 1000;
+
+    // Deferred emissions posted and processed in bursts
+    EventQueue queue(items);
+    Event<int> event;
+    subscribe(event, Kind::Lambda, 0, handlers);
+    Bench::report("queue/post+process/lambda/1", Bench::nsPerOp(rounds, [&] () {
+        for (std::size_t i = 0; i < items; ++i) {
+            queue.post(event, int(i));
+        }
+        queue.processEvents();
+    }) / items, "ns");
+    Bench::report("alloc/queue/post", Bench::allocsPerOp(items, [&] () {
+        queue.post(event, 1);
+    }), "allocs");
+    queue.processEvents();
+
+    // Emissions delivered to a handler bound to another thread
+    EventLoop loop;
+    loop.start();
+    Handler looped;
+    looped.setEventLoop(&loop);
+    Event<int> loopEvent;
+    loopEvent.addEventHandler(&looped, &Handler::method);
+    Bench::report("queue/event-loop/method/1", Bench::nsPerOp(rounds, [&] () {
+        for (std::size_t i = 0; i < items; ++i) {
+            loopEvent(int(i));
+        }
+        std::promise<void> done;
+        loop.post([&done] () { done.set_value(); });
+        done.get_future().wait();
+    }) / items, "ns");
+}
+
+static void subscription(Handler *handlers) {
+    for (std::size_t count : { 1, 8, 64, 1024 }) {
+        std::size_t rounds = 200000 / count;
+        for (Kind kind : { Kind::Function, Kind::Method, Kind::Lambda }) {
+            double subscribeNs = 0, byConnectionNs = 0, byValueNs = 0;
+            std::vector<Connection> connections(count);
+            for (std::size_t round = 0; round < rounds; ++round) {
+                Event<int> event;
+                subscribeNs += Bench::ns([&] () {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        connections[i] = subscribe(event, kind, i, handlers);
+                    }
+                });
+                byConnectionNs += Bench::ns([&] () {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        event.removeEventHandler(connections[i]);
+                    }
+                });
+                for (std::size_t i = 0; i < count; ++i) {
+                    subscribe(event, kind, i, handlers);
+                }
+                byValueNs += Bench::ns([&] () {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        unsubscribeByValue(event, kind, i, handlers);
+                    }
+                });
+            }
+            double operations = double(rounds) * count;
+            Bench::report(name("subscribe", kind, count), subscribeNs / operations, "ns");
+            Bench::report(name("unsubscribe/connection", kind, count), byConnectionNs / operations, "ns");
+            Bench::report(name("unsubscribe/value", kind, count), byValueNs / operations, "ns");
+        }
+    }
+}
+
+static void priorities() {
+    constexpr std::size_t count = 1024;
+    constexpr std::size_t rounds = 200;
+
+    // Handlers spread over 16 priorities, most are inserted mid-order
+    double subscribeNs = 0;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        Event<int> event;
+        subscribeNs += Bench::ns([&] () {
+            for (std::size_t i = 0; i < count; ++i) {
+                event.addEventHandler([i] (int value) { g_sink += value + int(i); }, int(i * 7 % 16));
+            }
+        });
+    }
+    Bench::report("subscribe/priority/lambda/1024", subscribeNs / (double(rounds) * count), "ns");
+
+    // One-shot handler attached and consumed by the next emission
+    Event<int> event;
+    Bench::report("emit/once/lambda/1", Bench::nsPerOp(1000000, [&] () {
+        event.addEventHandler([] (int value) { g_sink += value; }, 0, true);
+        event(1);
+    }), "ns");
+}
+
+static void fanIn() {
+    constexpr std::size_t count = 10000;
+    std::vector<std::unique_ptr<Handler>> owners;
+    std::vector<Handler *> objects;
+    for (std::size_t i = 0; i < count; ++i) {
+        owners.push_back(std::make_unique<Handler>());
+        objects.push_back(owners.back().get());
+    }
+
+    // Wiring many objects to one event, per object
+    {
+        Event<int> event;
+        Bench::report("subscribe/fan-in/single/10000", Bench::ns([&] () {
+            for (Handler *object : objects) {
+                event.addEventHandler(object, &Handler::method);
+            }
+        }) / count, "ns");
+    }
+    Event<int> event;
+    Bench::report("subscribe/fan-in/bulk/10000", Bench::ns([&] () {
+        event.addEventHandlers(objects, &Handler::method);
+    }) / count, "ns");
+    Bench::report("unsubscribe/fan-in/clear/10000", Bench::ns([&] () {
+        event.clear();
+    }) / count, "ns");
+}
+
+static void keyed() {
+    constexpr int handlers = 5000;
+    constexpr int keys = handlers / 3;
+
+    // Routing to 3 of 5000 handlers, by filtering in each handler and by key
+    Event<int> event;
+    KeyedEvent<int, int> keyedEvent;
+    for (int i = 0; i < handlers; ++i) {
+        int key = i % keys;
+        event.addEventHandler([key] (int value) {
+            if (value != key) {
+                return;
+            }
+            g_sink += value;
+        });
+        keyedEvent.addEventHandler(key, [i] (int value) { g_sink += value + i; });
+    }
+    Bench::report("emit/filtered/5000", Bench::nsPerOp(2000, [&] () {
+        event(42);
+    }), "ns");
+    Bench::report("emit/keyed/5000", Bench::nsPerOp(1000000, [&] () {
+        keyedEvent(42, 42);
+    }), "ns");
+}
+
+static void bus() {
+    constexpr std::size_t iterations = 1000000;
+    const std::string topic = "md.nyse.AAPL.trade";
+
+    // One handler per topic in a map of events, as done without the bus
+    std::unordered_map<std::string, Event<int>> events;
+    events[topic].addEventHandler([] (int value) { g_sink += value; });
+    Bench::report("publish/map/exact", Bench::nsPerOp(iterations, [&] () {
+        events[topic](1);
+    }), "ns");
+
+    EventBus<int> bus;
+    bus.addEventHandler(topic, [] (int value) { g_sink += value; });
+    Bench::report("publish/bus/exact", Bench::nsPerOp(iterations, [&] () {
+        bus.publish(topic, 1);
+    }), "ns");
+
+    // Three matching wildcard patterns among unrelated ones
+    for (int i = 0; i < 100; ++i) {
+        bus.addEventHandler("md.*.SYM" + std::to_string(i) + ".#", [] (int value) { g_sink += value; });
+    }
+    bus.addEventHandler("md.*.AAPL.#", [] (int value) { g_sink += value; });
+    bus.addEventHandler("md.#.trade", [] (int value) { g_sink += value; });
+    Bench::report("publish/bus/wildcard", Bench::nsPerOp(iterations, [&] () {
+        bus.publish(topic, 1);
+    }), "ns");
+    EventBus<int>::Topic interned = bus.topic(topic);
+    Bench::report("publish/bus/interned", Bench::nsPerOp(iterations, [&] () {
+        bus.publish(interned, 1);
+    }), "ns");
+}
+
+static void teardown() {
+    // Destruction of objects subscribed to one event, vs. the number of them
+    for (std::size_t count : { 64, 1024, 16384 }) {
+        Event<int> event;
+        std::vector<std::unique_ptr<Handler>> objects;
+        objects.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            objects.push_back(std::make_unique<Handler>());
+            event.addEventHandler(objects.back().get(), &Handler::method);
+        }
+        Bench::report("teardown/notifiable/" + std::to_string(count), Bench::ns([&] () {
+            objects.clear();
+        }) / count, "ns");
+    }
+
+    // Destruction of shared objects whose handlers hold weak references
+    for (std::size_t count : { 64, 1024, 16384 }) {
+        Event<int> event;
+        std::vector<std::shared_ptr<Handler>> objects;
+        objects.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            objects.push_back(std::make_shared<Handler>());
+            event.addEventHandler(std::weak_ptr<Handler>(objects.back()), &Handler::method);
+        }
+        Bench::report("teardown/weak/" + std::to_string(count), Bench::ns([&] () {
+            objects.clear();
+        }) / count, "ns");
+    }
+
+    // Destruction of an object subscribed to many events, per subscription
+    for (std::size_t count : { 1, 64, 1024 }) {
+        std::vector<Event<int>> events(count);
+        auto object = std::make_unique<Handler>();
+        for (Event<int> &event : events) {
+            event.addEventHandler(object.get(), &Handler::method);
+        }
+        Bench::report("teardown/subscriptions/" + std::to_string(count), Bench::ns([&] () {
+            object.reset();
+        }) / count, "ns");
+    }
+
+    // Event lifetime, the destructor always notifies the dispatcher
+    Handler handler;
+    Bench::report("lifetime/Event", Bench::nsPerOp(1000000, [] () {
+        Event<int> event;
+        Bench::doNotOptimize(event);
+    }), "ns");
+    Bench::report("lifetime/Event+method", Bench::nsPerOp(1000000, [&] () {
+        Event<int> event;
+        event.addEventHandler(&handler, &Handler::method);
+    }), "ns");
+}
+
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            Bench::g_json = true;
+        }
+    }
+
+    auto handlers = std::make_unique<Handler[]>(maxHandlers);
+    footprint(handlers.get());
+    allocations(handlers.get());
+    invocation(handlers.get());
+    emission(handlers.get());
+    policies();
+    results();
+    parallel();
+    batches(handlers.get());
+    queues(handlers.get());
+    subscription(handlers.get());
+    priorities();
+    fanIn();
+    keyed();
+    bus();
+    teardown();
+
+    if (Bench::g_json) {
+        Bench::printJson("HlkEvents", HLK_EVENTS_VERSION, HLK_EVENTS_LIBRARY_TYPE);
+    }
+
+    Bench::doNotOptimize(g_sink);
+    return 0;
+}
@@ -23,7 +23,10 @@
 #ifndef HLK_ABSTRACT_EVENT_H
 #define HLK_ABSTRACT_EVENT_H
 
-#include "abstractdelegate.h"
+#include "attachment.h"
+#include "connection.h"
+
+#include <type_traits>
 
 namespace Hlk {
 
@@ -39,7 +42,45 @@ public:
      * Methods
      *************************************************************************/
 
-    virtual void removeEventHandler(AbstractDelegate *delegate) = 0;
+    virtual void removeEventHandler(const Connection &connection) = 0;
+
+    // Name given to the event for instrumentation, empty by default
+    virtual const char *name() const { return ""; }
+
+protected:
+    friend class EventDispatcher;
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    /* Lock guarding the handlers and the attachments of the event, its type 
+    depends on the threading policy of the event. Only called by the 
+    dispatcher for events with attachments */
+    virtual bool tryLockHandlers() = 0;
+    virtual void unlockHandlers() = 0;
+
+    /* Head of the intrusive list of attachments, kept by the event so it 
+    may store it with its handlers, the handlers are locked */
+    virtual Attachment *&attachments() = 0;
+
+    // Removes the handler of a destroyed object, the handlers are locked
+    virtual void unsafeRemoveEventHandler(const Connection &connection) = 0;
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    /* Argument of a handler which doesn't consume the emission arguments: a 
+    copy of a value, a reference or a moved move-only value */
+    template<class T>
+    static inline T copyArgument(std::remove_reference_t<T> &value) {
+        if constexpr (std::is_reference_v<T> || !std::is_copy_constructible_v<T>) {
+            return static_cast<T &&>(value);
+        } else {
+            return value;
+        }
+    }
 };
 
 } // namespace Hlk
@@ -0,0 +1,57 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_ABSTRACT_EXECUTOR_H
+#define HLK_ABSTRACT_EXECUTOR_H
+
+#include "delegate.h"
+
+namespace Hlk {
+
+class AbstractExecutor {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    using Task = Delegate<void()>;
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    virtual ~AbstractExecutor() = default;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Schedules the task, must be callable from any thread
+    virtual void execute(Task &&task) = 0;
+
+    // Number of tasks that may run at the same time, used to split work
+    virtual unsigned int concurrency() const { return 1; }
+};
+
+} // namespace Hlk
+
+#endif // HLK_ABSTRACT_EXECUTOR_H
@@ -23,6 +23,12 @@
 #ifndef HLK_ABSTRACT_WRAPPER_H
 #define HLK_ABSTRACT_WRAPPER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace Hlk {
 
 template<class TFunction>
@@ -32,6 +38,16 @@ template<class TReturn, class... TArgs>
 class AbstractWrapper<TReturn(TArgs...)> {
     using TWrapper = AbstractWrapper<TReturn(TArgs...)>;
 public:
+    /**************************************************************************
+     * Constants
+     *************************************************************************/
+
+    /* Size of the inline storage reserved by Delegate for its wrapper. With
+    the delegate's own pointers this keeps a Delegate within one cache line
+    while fitting method wrappers and lambdas with a few captures */
+    static constexpr std::size_t inlineStorageSize = 6 * sizeof(void *);
+    static constexpr std::size_t inlineStorageAlign = alignof(std::max_align_t);
+
     /**************************************************************************
      * Constructors / Destructors
      *************************************************************************/
@@ -42,27 +58,134 @@ public:
      * Methods
      *************************************************************************/
 
-    virtual TWrapper *clone() = 0;    
-    virtual TReturn operator()(TArgs...) = 0;
+    /**
+     * @brief Copies the wrapper into the storage or onto the heap
+     * 
+     * @param storage inline storage of at least inlineStorageSize bytes
+     * @return pointer to the copy, equal to storage if the copy was placed
+     * inline
+     */
+    virtual TWrapper *clone(void *storage) const = 0;
+
+    /**
+     * @brief Moves the wrapper placed inline into the storage
+     * 
+     * @return pointer to the moved wrapper, this if the wrapper is on the heap 
+     * and only its ownership has to be transferred
+     */
+    virtual TWrapper *move(void *storage) = 0;
+
+    // Destroys the wrapper created by clone(), move() or emplace()
+    virtual void destroy() = 0;
+
+    // True once the target is gone, e.g. the object of WeakMethodWrapper
+    virtual bool expired() const { return false; }
+
+    /* Value arguments are taken by rvalue reference and moved into the 
+    target, so calling through the wrapper adds no copies */
+    virtual TReturn operator()(TArgs&&... args) = 0;
+
+    // Tag unique to the concrete wrapper type
+    inline const void *tag() const { return m_tag; }
+
+    // Hash of the tag and the bound target, equal wrappers have equal hashes
+    inline std::size_t hash() const { return m_hash; }
 
     /**************************************************************************
      * Overloaded operators
      *************************************************************************/
 
+    /* Wrappers of different types or targets are told apart without a virtual
+    call, isEquals() is reached only for the same type and hash */
     inline bool operator==(const TWrapper &other) const {
-        return isEquals(other);
+        return m_tag == other.m_tag && m_hash == other.m_hash && isEquals(other);
     }
 
     bool operator!=(const TWrapper &other) const {
         return !(*this == other);
     }
 
+    /**************************************************************************
+     * Static methods
+     *************************************************************************/
+
+    // Tag of the wrapper type, equal to tag() of its instances
+    template<class TConcrete>
+    static const void *typeTag() {
+        return &TypeTag<TConcrete>::id;
+    }
+
+    // Constructs a wrapper inline if it fits the storage, otherwise on the heap
+    template<class TConcrete, class... TCtorArgs>
+    static TWrapper *emplace(void *storage, TCtorArgs &&... args) {
+        if constexpr (fitsInline<TConcrete>()) {
+            return new (storage) TConcrete(std::forward<TCtorArgs>(args)...);
+        } else {
+            return new TConcrete(std::forward<TCtorArgs>(args)...);
+        }
+    }
+
+    // Moves an inline wrapper into the storage, heap wrappers stay in place
+    template<class TConcrete>
+    static TWrapper *relocate(void *storage, TConcrete &wrapper) {
+        if constexpr (fitsInline<TConcrete>()) {
+            return new (storage) TConcrete(std::move(wrapper));
+        } else {
+            return &wrapper;
+        }
+    }
+
+    template<class TConcrete>
+    static void dispose(TConcrete *wrapper) {
+        if constexpr (fitsInline<TConcrete>()) {
+            wrapper->~TConcrete();
+        } else {
+            delete wrapper;
+        }
+    }
+
+    template<class TConcrete>
+    static constexpr bool fitsInline() {
+        return sizeof(TConcrete) <= inlineStorageSize
+            && alignof(TConcrete) <= inlineStorageAlign
+            && std::is_nothrow_move_constructible_v<TConcrete>;
+    }
+
 protected:
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    // FNV-1a over the bytes of the bound target
+    static std::size_t hashBytes(const void *data, std::size_t size, std::size_t seed) {
+        auto bytes = static_cast<const unsigned char *>(data);
+        std::uint64_t hash = 14695981039346656037ull ^ seed;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return static_cast<std::size_t>(hash);
+    }
+
     /**************************************************************************
      * Methods (Protected)
      *************************************************************************/
 
+    // Called only for wrappers with equal tags, so other is of the same type
     virtual bool isEquals(const TWrapper &other) const = 0;
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    const void *m_tag = nullptr;
+    std::size_t m_hash = 0;
+
+private:
+    template<class TConcrete>
+    struct TypeTag {
+        static constexpr char id = 0;
+    };
 };
 
 } // namespace Hlk
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_ATTACHMENT_H
+#define HLK_ATTACHMENT_H
+
+#include "connection.h"
+
+namespace Hlk {
+
+class AbstractEvent;
+class NotifiableObject;
+
+/**
+ * @brief Link between an event handler and the object it belongs to
+ * 
+ * Every attachment is a node of two intrusive lists: the list of the event 
+ * and the list of the notifiable object, so destroying either side only 
+ * touches its own attachments. Managed by EventDispatcher.
+ */
+struct Attachment {
+    AbstractEvent *event = nullptr;
+    NotifiableObject *notifiable = nullptr;
+    Connection connection;
+
+    Attachment *eventPrev = nullptr;
+    Attachment *eventNext = nullptr;
+    Attachment *notifiablePrev = nullptr;
+    Attachment *notifiableNext = nullptr;
+};
+
+} // namespace Hlk
+
+#endif // HLK_ATTACHMENT_H
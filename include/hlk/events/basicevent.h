@@ -0,0 +1,775 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_BASIC_EVENT_H
+#define HLK_BASIC_EVENT_H
+
+#include "abstractevent.h"
+#include "delegate.h"
+#include "eventdispatcher.h"
+#include "handlerlist.h"
+#include "instrumentation.h"
+#include "notifiableobject.h"
+#include "queuedwrapper.h"
+#include "threadingpolicy.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Hlk {
+
+template<class TFunction, class TPolicy = MultiThreaded>
+class BasicEvent;
+
+/**
+ * @brief Handler storage shared by Event and its result collecting form
+ * 
+ * Owns the handlers and their attachments to notifiable objects, implements 
+ * subscription, removal, copying and moving, and the emission loop which 
+ * the derived events run their handlers through. Everything is kept in a 
+ * state block allocated on first use, so an event nobody subscribes to is 
+ * one pointer besides the vtable and its emission is a null check.
+ * 
+ * @tparam TReturn return type of the handlers
+ * @tparam TArgs event arguments
+ * @tparam TPolicy ThreadingPolicy choosing the lock of the handlers and 
+ * whether handlers of notifiable objects are tracked
+ */
+template<class TReturn, class... TArgs, class TPolicy>
+class BasicEvent<TReturn(TArgs...), TPolicy> : public AbstractEvent {
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    using TDelegate = Delegate<TReturn(TArgs...)>;
+
+    /* Shared with the tasks of asynchronous emissions of Event. The event 
+    pointer is reset on destruction, so tasks executed later are dropped. 
+    Recursive, because a handler may destroy the event during such an 
+    emission */
+    struct AsyncState {
+        std::recursive_mutex mutex;
+        BasicEvent *event;
+    };
+
+    /* Handlers are kept on the heap together with their mutex, so an 
+    emission can finish safely after some handler destroyed the event */
+    struct State {
+        typename TPolicy::Mutex mutex;
+        HandlerList<TDelegate> handlers;
+        Attachment *attachments = nullptr;
+        AbstractExecutor *executor = nullptr;
+        std::shared_ptr<AsyncState> asyncState;
+        bool destroyed = false;
+
+        // Empty unless instrumentation is enabled, so it fits the padding
+        EventStats stats;
+    };
+
+    /* Handlers of a parallel emission, claimed in chunks by the emitting 
+    thread and the executor tasks. Tasks which start late find no chunks 
+    left and only release their reference */
+    template<class TInvoke>
+    struct ParallelJob {
+        std::vector<TDelegate *> delegates;
+        TInvoke *invoke = nullptr;
+        EventStats *stats = nullptr;
+        size_t grain = 1;
+        std::atomic<size_t> next { 0 };
+        std::atomic<size_t> done { 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        // Calls chunks of handlers until all are claimed
+        void run() {
+            const size_t count = delegates.size();
+            for (;;) {
+                size_t first = next.fetch_add(grain);
+                if (first >= count) {
+                    return;
+                }
+                size_t last = std::min(first + grain, count);
+                for (size_t i = first; i < last; ++i) {
+                    Stopwatch stopwatch;
+                    (*invoke)(*delegates[i]);
+                    stats->recordHandler(stopwatch);
+                }
+                if (done.fetch_add(last - first) + (last - first) == count) {
+                    std::unique_lock lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+
+        // Waits until every handler has returned
+        void wait() {
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [this] () { return done.load() == delegates.size(); });
+        }
+    };
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    BasicEvent() = default;
+
+    BasicEvent(const BasicEvent &other) {
+        State *otherState = other.currentState();
+        if (otherState == nullptr) {
+            return;
+        }
+
+        State *state = this->state();
+        std::scoped_lock lock(state->mutex, otherState->mutex);
+        unsafeCopyHandlers(other);
+    }
+
+    BasicEvent(BasicEvent && other) {
+        State *state = other.currentState();
+        if (state == nullptr) {
+            return;
+        }
+
+        /* The attachments move with the locked state, so the dispatcher 
+        finds the locked mutex through either event until they point here */
+        std::unique_lock lock(state->mutex);
+        m_state.store(state, std::memory_order_release);
+        state->stats.setEvent(this);
+        if constexpr (TPolicy::tracksObjects) {
+            EventDispatcher::getInstance()->eventMoved(this);
+        }
+        other.m_state.store(nullptr, std::memory_order_release);
+    }
+
+    virtual ~BasicEvent() {
+        State *state = currentState();
+        if (state == nullptr) {
+            return;
+        }
+
+        std::unique_lock lock(state->mutex);
+        if constexpr (TPolicy::tracksObjects) {
+            EventDispatcher::getInstance()->eventDestroyed(this);
+        }
+        state->stats.setEvent(nullptr);
+
+        /* The event is currently being processed. Some event handler caused the 
+        deletion of the object containing the event, the emission will delete 
+        the state */
+        if (state->handlers.isEmitting()) {
+            state->destroyed = true;
+            return;
+        }
+
+        lock.unlock();
+        delete state;
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Remove the event handler by its connection, O(1)
+    virtual void removeEventHandler(const Connection &connection) override {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveConnection(connection);
+        }
+    }
+
+    // Remove event handler equal to the delegate, safe
+    void removeEventHandler(TDelegate *delegate) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveEventHandler(*delegate);
+        }
+    }
+
+    /**
+     * @brief Creates function delegate and attaches it to the Event
+     * 
+     * Handlers with higher priority are called first, handlers of equal 
+     * priority in the order they were attached. A handler attached once is 
+     * removed by the first emission that calls it, before the call.
+     * 
+     * @param func attached function
+     * @param priority call order priority, 0 by default
+     * @param once remove the handler after the first call
+     * @return connection of the handler, the existing one if the function is 
+     * already attached, it keeps its priority
+     */
+    Connection addEventHandler(TReturn (*func)(TArgs...), int priority = 0, bool once = false) {
+        std::unique_lock lock(state()->mutex);
+        return unsafeAddEventHandler(TDelegate(func), nullptr, priority, once);
+    }
+
+    /**
+     * @brief Creates method delegate and attaches it to the Event
+     * 
+     * The attached class must inherit from NotifiableObject. This is necessary 
+     * to store all registered events (including communication with the object 
+     * and delegate) in the process, which, in turn, allows you to remove 
+     * handlers of destroyed objects from events. If the object is bound to 
+     * an EventLoop, a handler without result runs on the loop thread.
+     * 
+     * @tparam TObject attached Class
+     * @param object attached Object
+     * @param method attached Method
+     * @param priority call order priority, see addEventHandler(TReturn (*)(TArgs...))
+     * @param once remove the handler after the first call
+     * @return connection of the handler
+     */
+    template<class TObject>
+    Connection addEventHandler(TObject *object, TReturn (TObject::*method)(TArgs...), 
+        int priority = 0, bool once = false) {
+        std::unique_lock lock(state()->mutex);
+        return unsafeAddEventHandler(bindToEventLoop(TDelegate(object, method), object), object, priority, once);
+    }
+
+    /**
+     * @brief Creates lambda delegate and attaches it to the Event
+     * 
+     * Attaches a lambda to the Event with no context tracking. This means that 
+     * calling a lambda with a lambda-capture can cause undefined behavior. For 
+     * example, if instead of attaching to a method event, a lambda was attached 
+     * with a captured "this", deleting the event handler object would not 
+     * remove the lambda handler from the event, so the lambda could refer to an 
+     * invalid "this" capture or be an invalid lambda reference.
+     * 
+     * @tparam TLambda lambda template
+     * @param lambda attached lambda object
+     * @param priority call order priority, see addEventHandler(TReturn (*)(TArgs...))
+     * @param once remove the handler after the first call
+     * @return connection of the handler, the only way to remove it
+     */
+    template<class TLambda, class = std::enable_if_t<std::is_invocable_v<TLambda &, TArgs...>>>
+    Connection addEventHandler(TLambda && lambda, int priority = 0, bool once = false) {
+        std::unique_lock lock(state()->mutex);
+        return unsafeAddEventHandler(TDelegate(std::forward<TLambda>(lambda)), nullptr, priority, once);
+    }
+
+    // Attaches lambda which is removed when the context is destroyed
+    template<class TLambda>
+    Connection addEventHandler(NotifiableObject *context, TLambda && lambda, 
+        int priority = 0, bool once = false) {
+        std::unique_lock lock(state()->mutex);
+        return unsafeAddEventHandler(bindToEventLoop(TDelegate(std::forward<TLambda>(lambda)), context), 
+            context, priority, once);
+    }
+
+    /**
+     * @brief Attaches method of an object owned by std::shared_ptr
+     * 
+     * The event keeps only a weak reference, so the object needs no base 
+     * class and the dispatcher is not involved. Each call locks the object, 
+     * a handler whose object has expired is skipped and removed by the 
+     * emission reaching it, or by removeEventHandler().
+     * 
+     * @tparam TObject attached class
+     * @param object attached object
+     * @param method attached method
+     * @param priority call order priority, see addEventHandler(TReturn (*)(TArgs...))
+     * @param once remove the handler after the first call
+     * @return connection of the handler
+     */
+    template<class TObject>
+    Connection addEventHandler(const std::weak_ptr<TObject> &object, TReturn (TObject::*method)(TArgs...), 
+        int priority = 0, bool once = false) {
+        std::unique_lock lock(state()->mutex);
+        return unsafeAddEventHandler(TDelegate(object, method), nullptr, priority, once, true);
+    }
+
+    // Attaches method of the shared object by a weak reference, see above
+    template<class TObject>
+    Connection addEventHandler(const std::shared_ptr<TObject> &object, TReturn (TObject::*method)(TArgs...), 
+        int priority = 0, bool once = false) {
+        return addEventHandler(std::weak_ptr<TObject>(object), method, priority, once);
+    }
+
+    // Remove function event handler
+    void removeEventHandler(TReturn (*func)(TArgs...)) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveEventHandler(TDelegate(func));
+        }
+    }
+
+    // Remove method event handler
+    template<class TObject>
+    void removeEventHandler(TObject *object, TReturn (TObject::*method)(TArgs...)) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveEventHandler(bindToEventLoop(TDelegate(object, method), object));
+        }
+    }
+
+    // Remove method event handler of the object held by a weak reference
+    template<class TObject>
+    void removeEventHandler(const std::weak_ptr<TObject> &object, TReturn (TObject::*method)(TArgs...)) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveEventHandler(TDelegate(object, method));
+        }
+    }
+
+    // Remove lambda event handler
+    template<class TLambda, class = std::enable_if_t<std::is_invocable_v<TLambda &, TArgs...>>>
+    void removeEventHandler(TLambda && lambda) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeRemoveEventHandler(TDelegate(std::forward<TLambda>(lambda)));
+        }
+    }
+
+    /**
+     * @brief Attaches the method of every object in the range
+     * 
+     * Equivalent to addEventHandler(object, method, priority) for each 
+     * object, but the event is locked once and its storage is reserved up 
+     * front, so wiring many objects to one event is linear.
+     * 
+     * @tparam TRange range of TObject pointers, e.g. std::vector<TObject *>
+     * @tparam TObject attached class
+     * @param objects attached objects
+     * @param method attached method
+     * @param priority call order priority of the handlers
+     * @return connections of the handlers in the order of the range
+     */
+    template<class TRange, class TObject>
+    std::vector<Connection> addEventHandlers(const TRange &objects, TReturn (TObject::*method)(TArgs...), 
+        int priority = 0) {
+        std::vector<Connection> connections;
+        connections.reserve(std::size(objects));
+
+        State *state = this->state();
+        std::unique_lock lock(state->mutex);
+        state->handlers.reserve(std::size(objects));
+        for (TObject *object : objects) {
+            connections.push_back(unsafeAddEventHandler(
+                bindToEventLoop(TDelegate(object, method), object), object, priority));
+        }
+        return connections;
+    }
+
+    // Attaches every function, lambda or delegate in the range, see above
+    template<class TRange>
+    std::vector<Connection> addEventHandlers(const TRange &handlers, int priority = 0) {
+        std::vector<Connection> connections;
+        connections.reserve(std::size(handlers));
+
+        State *state = this->state();
+        std::unique_lock lock(state->mutex);
+        state->handlers.reserve(std::size(handlers));
+        for (const auto &handler : handlers) {
+            connections.push_back(unsafeAddEventHandler(TDelegate(handler), nullptr, priority));
+        }
+        return connections;
+    }
+
+    // Removes the handlers of the connections under one lock
+    template<class TRange>
+    void removeEventHandlers(const TRange &connections) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            for (const Connection &connection : connections) {
+                unsafeRemoveConnection(connection);
+            }
+        }
+    }
+
+    // Removes the method of every object in the range under one lock
+    template<class TRange, class TObject>
+    void removeEventHandlers(const TRange &objects, TReturn (TObject::*method)(TArgs...)) {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            for (TObject *object : objects) {
+                unsafeRemoveEventHandler(bindToEventLoop(TDelegate(object, method), object));
+            }
+        }
+    }
+
+    // Number of attached handlers
+    size_t size() const {
+        State *state = currentState();
+        if (state == nullptr) {
+            return 0;
+        }
+        std::unique_lock lock(state->mutex);
+        return state->handlers.size();
+    }
+
+    // Removes all handlers, O(n)
+    void clear() {
+        if (State *state = currentState()) {
+            std::unique_lock lock(state->mutex);
+            unsafeClear();
+        }
+    }
+
+    /**
+     * @brief Names the event in instrumentation snapshots and traces
+     * 
+     * Without instrumentation names are not stored and name() stays empty. 
+     * Copies of the event are not named, a moved event keeps its name. Every 
+     * distinct name is kept until the process exits, traces refer to it.
+     */
+    void setName(const std::string &name) {
+        if constexpr (Instrumentation::enabled) {
+            state()->stats.setName(name);
+        }
+    }
+
+    virtual const char *name() const override {
+        State *state = currentState();
+        return state ? state->stats.name() : "";
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    // Copy assignment operator
+    BasicEvent& operator=(const BasicEvent &other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        State *otherState = other.currentState();
+        if (otherState == nullptr) {
+            clear();
+            return *this;
+        }
+
+        State *state = this->state();
+        std::scoped_lock lock(state->mutex, otherState->mutex);
+
+        unsafeClear();
+        unsafeCopyHandlers(other);
+
+        return *this;
+    }
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    /**
+     * @brief Runs the handlers attached when the emission starts
+     * 
+     * The lock is released while a handler runs. Handlers attached during 
+     * the emission are called from the next one, so a handler re-attaching 
+     * itself or a resumed coroutine waiting for the next emission doesn't get 
+     * this one again. Handlers attached once are removed here, before they 
+     * are called, so concurrent emissions never call them twice. So are 
+     * handlers of expired weak references, without being called.
+     * 
+     * @param invoke called as invoke(delegate) or invoke(delegate, last), 
+     * where last is true for the last handler to be called. May return false 
+     * to stop the emission
+     */
+    template<class TInvoke>
+    void forEachHandler(TInvoke &&invoke) {
+        /* If the handler destroys the event, the state is kept until the 
+        emission ends, so only the local copy of the pointer is used below */
+        State *state = currentState();
+
+        // Nobody has subscribed yet
+        if (state == nullptr) {
+            return;
+        }
+
+        // Lock to avoid append or delete event handlers
+        std::unique_lock lock(state->mutex, std::defer_lock);
+        state->stats.acquire(lock);
+
+        // Already deleted
+        if (state->destroyed) {
+            return;
+        }
+
+        HandlerList<TDelegate> &handlers = state->handlers;
+        handlers.beginEmission();
+        Stopwatch emission = state->stats.beginEmission(handlers.size());
+
+        const size_t positions = handlers.positions();
+        for (size_t i = 0; i < positions && !state->destroyed; ++i) {
+            // Skip removed event handlers
+            TDelegate *delegate = handlers.at(i);
+            if (delegate == nullptr) {
+                continue;
+            }
+
+            // Prune the handler of a destroyed object
+            if (handlers.hasWeak() && handlers.isWeak(i) && delegate->expired()) {
+                unsafeRemoveConnection(handlers.connectionAt(i));
+                continue;
+            }
+
+            if (handlers.hasOnce() && handlers.isOnce(i)) {
+                // The delegate is destroyed when the emission ends
+                unsafeRemoveConnection(handlers.connectionAt(i));
+            }
+
+            bool proceed = true;
+            if constexpr (std::is_invocable_v<TInvoke &, TDelegate &, bool>) {
+                bool last = handlers.isLast(i, positions);
+                lock.unlock();
+                Stopwatch stopwatch;
+                proceed = callHandler(invoke, *delegate, last);
+                state->stats.recordHandler(stopwatch);
+            } else {
+                lock.unlock();
+                Stopwatch stopwatch;
+                proceed = callHandler(invoke, *delegate);
+                state->stats.recordHandler(stopwatch);
+            }
+            state->stats.acquire(lock);
+
+            if (!proceed) {
+                break;
+            }
+        }
+
+        handlers.endEmission();
+        state->stats.endEmission(emission);
+
+        // Someone destroyed this event during execution
+        if (state->destroyed && !handlers.isEmitting()) {
+            lock.unlock();
+            delete state;
+        }
+    }
+
+    /**
+     * @brief Runs the handlers attached when the emission starts in parallel
+     * 
+     * The handlers are split between the calling thread and up to 
+     * concurrency() tasks of the executor of the event, ThreadPool by 
+     * default. Each of them claims chunks of the handler list until none are 
+     * left, so there is one task per worker rather than per handler, and a 
+     * busy executor only makes the calling thread do more of the work. 
+     * Returns when all handlers have returned. Handlers removed during the 
+     * emission may still be called by it.
+     * 
+     * @param invoke called as invoke(delegate) from several threads at once
+     */
+    template<class TInvoke>
+    void forEachHandlerParallel(TInvoke &invoke) {
+        State *state = currentState();
+        if (state == nullptr) {
+            return;
+        }
+
+        std::unique_lock lock(state->mutex, std::defer_lock);
+        state->stats.acquire(lock);
+        if (state->destroyed) {
+            return;
+        }
+
+        HandlerList<TDelegate> &handlers = state->handlers;
+        handlers.beginEmission();
+        Stopwatch emission = state->stats.beginEmission(handlers.size());
+
+        auto job = std::make_shared<ParallelJob<TInvoke>>();
+        job->delegates.reserve(handlers.size());
+        for (size_t i = 0; i < handlers.positions(); ++i) {
+            TDelegate *delegate = handlers.at(i);
+            if (delegate == nullptr) {
+                continue;
+            }
+            if (handlers.hasWeak() && handlers.isWeak(i) && delegate->expired()) {
+                unsafeRemoveConnection(handlers.connectionAt(i));
+                continue;
+            }
+            if (handlers.hasOnce() && handlers.isOnce(i)) {
+                unsafeRemoveConnection(handlers.connectionAt(i));
+            }
+            job->delegates.push_back(delegate);
+        }
+        AbstractExecutor *executor = state->executor ? state->executor : ThreadPool::getInstance();
+        lock.unlock();
+
+        const size_t count = job->delegates.size();
+        if (count != 0) {
+            size_t helpers = std::min<size_t>(executor->concurrency(), count - 1);
+            job->invoke = &invoke;
+            job->stats = &state->stats;
+            job->grain = std::max<size_t>(1, count / ((helpers + 1) * 4));
+            for (size_t i = 0; i < helpers; ++i) {
+                executor->execute([job] () { job->run(); });
+            }
+            job->run();
+            job->wait();
+        }
+
+        state->stats.acquire(lock);
+        handlers.endEmission();
+        state->stats.endEmission(emission);
+
+        // Someone destroyed this event during execution
+        if (state->destroyed && !handlers.isEmitting()) {
+            lock.unlock();
+            delete state;
+        }
+    }
+
+    // Creates the state on first use, races for it are settled by a CAS
+    State *state() {
+        State *state = currentState();
+        if (state != nullptr) {
+            return state;
+        }
+
+        state = new State();
+        state->stats.setEvent(this);
+        State *expected = nullptr;
+        if (!m_state.compare_exchange_strong(expected, state, std::memory_order_acq_rel)) {
+            delete state;
+            return expected;
+        }
+        return state;
+    }
+
+    // State or nullptr if the event was never subscribed to
+    inline State *currentState() const {
+        return m_state.load(std::memory_order_acquire);
+    }
+
+    // The unsafe methods below are called with the mutex of the state locked
+
+    inline Connection unsafeAddEventHandler(TDelegate &&delegate, NotifiableObject *notifiable = nullptr,
+        int priority = 0, bool once = false, bool weak = false) {
+        HandlerList<TDelegate> &handlers = currentState()->handlers;
+
+        // Try to find some delegate in handlers
+        Connection connection = handlers.find(delegate);
+        if (connection.isValid()) {
+            return connection;
+        }
+
+        connection = handlers.append(std::move(delegate), priority, once, weak);
+        if (TPolicy::tracksObjects && notifiable) {
+            handlers.setAttachment(
+                connection, 
+                EventDispatcher::getInstance()->registerAttachment(this, notifiable, connection)
+            );
+        }
+        return connection;
+    }
+
+    inline void unsafeRemoveEventHandler(const TDelegate &delegate) {
+        unsafeRemoveConnection(currentState()->handlers.find(delegate));
+    }
+
+    inline void unsafeRemoveConnection(const Connection &connection) {
+        HandlerList<TDelegate> &handlers = currentState()->handlers;
+        if (Attachment *attachment = handlers.attachment(connection)) {
+            EventDispatcher::getInstance()->removeAttachment(attachment);
+        }
+        handlers.remove(connection);
+    }
+
+    inline void unsafeClear() {
+        if constexpr (TPolicy::tracksObjects) {
+            EventDispatcher::getInstance()->removeAttachments(this);
+        }
+        currentState()->handlers.clear();
+    }
+
+    // Copies delegates and their attachments, both events must be locked
+    void unsafeCopyHandlers(const BasicEvent &other) {
+        HandlerList<TDelegate> &handlers = other.currentState()->handlers;
+        currentState()->handlers.reserve(handlers.size());
+        for (size_t i = 0; i < handlers.positions(); ++i) {
+            TDelegate *delegate = handlers.at(i);
+            if (delegate == nullptr) {
+                continue;
+            }
+            Attachment *attachment = handlers.attachment(handlers.connectionAt(i));
+            unsafeAddEventHandler(TDelegate(*delegate), attachment ? attachment->notifiable : nullptr, 
+                handlers.priorityAt(i), handlers.isOnce(i), handlers.isWeak(i));
+        }
+    }
+
+    virtual bool tryLockHandlers() override {
+        return currentState()->mutex.try_lock();
+    }
+
+    virtual void unlockHandlers() override {
+        currentState()->mutex.unlock();
+    }
+
+    virtual Attachment *&attachments() override {
+        return currentState()->attachments;
+    }
+
+    // Remove the handler without touching its attachment
+    virtual void unsafeRemoveEventHandler(const Connection &connection) override {
+        currentState()->handlers.remove(connection);
+    }
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    // Handlers without results run on the event loop of their object if it has one
+    static TDelegate bindToEventLoop(TDelegate &&delegate, NotifiableObject *object) {
+        if constexpr (std::is_void_v<TReturn>) {
+            return QueuedWrapper<void(TArgs...)>::bind(std::move(delegate), object);
+        } else {
+            return std::move(delegate);
+        }
+    }
+
+    // Calls the emission callback, a callback returning nothing never stops it
+    template<class TInvoke, class... TCallArgs>
+    static inline bool callHandler(TInvoke &invoke, TCallArgs &&... args) {
+        if constexpr (std::is_void_v<std::invoke_result_t<TInvoke &, TCallArgs...>>) {
+            invoke(std::forward<TCallArgs>(args)...);
+            return true;
+        } else {
+            return invoke(std::forward<TCallArgs>(args)...);
+        }
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::atomic<State *> m_state { nullptr };
+};
+
+} // namespace Hlk
+
+#endif // HLK_BASIC_EVENT_H
@@ -0,0 +1,141 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_BATCH_WRAPPER_H
+#define HLK_BATCH_WRAPPER_H
+
+#include "delegate.h"
+#include "span.h"
+
+#include <tuple>
+#include <type_traits>
+
+namespace Hlk {
+
+// Element of a batch emission: the decayed argument, or a tuple of them
+template<class... TArgs>
+struct BatchItem {
+    using Type = std::tuple<std::decay_t<TArgs>...>;
+};
+
+template<class TArg>
+struct BatchItem<TArg> {
+    using Type = std::decay_t<TArg>;
+};
+
+template<class TFunction>
+class BatchWrapper;
+
+/**
+ * @brief Wrapper of a handler taking a whole batch of emissions
+ * 
+ * Stored among per-item handlers of an event and recognized by its type tag 
+ * on batch emission. A single emission is passed as a batch of one item.
+ */
+template<class... TArgs>
+class BatchWrapper<void(TArgs...)> : public AbstractWrapper<void(TArgs...)> {
+    using TBWrapper = BatchWrapper<void(TArgs...)>;
+    using TItem = typename BatchItem<TArgs...>::Type;
+public:
+    using TBatch = Span<const TItem>;
+    using TBatchDelegate = Delegate<void(TBatch)>;
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    // Auto-bind constructor
+    BatchWrapper(TBatchDelegate &&handler) 
+    : m_handler(std::move(handler)) {
+        this->m_tag = this->template typeTag<TBWrapper>();
+        std::size_t hash = m_handler.hash();
+        this->m_hash = this->hashBytes(&hash, sizeof(hash), reinterpret_cast<std::size_t>(this->m_tag));
+    }
+
+    // Copy constructor
+    BatchWrapper(const BatchWrapper &other) 
+    : AbstractWrapper<void(TArgs...)>(other),
+      m_handler(other.m_handler) { }
+
+    // Move constructor
+    BatchWrapper(BatchWrapper&& other) noexcept
+    : AbstractWrapper<void(TArgs...)>(other),
+      m_handler(std::move(other.m_handler)) { }
+
+    virtual ~BatchWrapper() = default;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    virtual AbstractWrapper<void(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TBWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<void(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TBWrapper>(storage, *this);
+    }
+
+    virtual void destroy() override {
+        this->template dispose<TBWrapper>(this);
+    }
+
+    void invokeBatch(TBatch batch) {
+        m_handler.invoke(std::move(batch));
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    virtual void operator()(TArgs&&... args) override {
+        if constexpr (sizeof...(TArgs) == 1) {
+            // The argument itself is the item
+            invokeBatch(TBatch(&args..., 1));
+        } else {
+            const TItem item(std::forward<TArgs>(args)...);
+            invokeBatch(TBatch(&item, 1));
+        }
+    }
+
+    BatchWrapper& operator=(const BatchWrapper &other) = delete;
+    BatchWrapper& operator=(BatchWrapper&& other) = delete;
+
+protected:
+    /**************************************************************************
+     * Method (Protected)
+     *************************************************************************/
+
+    virtual bool isEquals(const AbstractWrapper<void(TArgs...)> &other) const override {
+        return m_handler == static_cast<const TBWrapper &>(other).m_handler;
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    TBatchDelegate m_handler;
+};
+
+} // namespace Hlk
+
+#endif // HLK_BATCH_WRAPPER_H
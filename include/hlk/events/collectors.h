@@ -0,0 +1,122 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_COLLECTORS_H
+#define HLK_COLLECTORS_H
+
+#include "span.h"
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace Hlk {
+
+/* Collectors of the results of Event<TReturn(TArgs...)> handlers. collect() 
+gets the result of every called handler and returns false to stop the 
+emission, result() is returned by Event::emit() */
+
+// Result of the first handler, the others are not called
+template<class T>
+class FirstResult {
+public:
+    bool collect(T &&value) {
+        m_result.emplace(std::move(value));
+        return false;
+    }
+
+    std::optional<T> result() { return std::move(m_result); }
+
+protected:
+    std::optional<T> m_result;
+};
+
+// Result of the last handler
+template<class T>
+class LastResult {
+public:
+    bool collect(T &&value) {
+        m_result.emplace(std::move(value));
+        return true;
+    }
+
+    std::optional<T> result() { return std::move(m_result); }
+
+protected:
+    std::optional<T> m_result;
+};
+
+// Results written to a preallocated buffer, stops once it is full
+template<class T>
+class AllResults {
+public:
+    explicit AllResults(Span<T> buffer) 
+    : m_buffer(buffer) { }
+
+    bool collect(T &&value) {
+        if (m_size < m_buffer.size()) {
+            m_buffer[m_size++] = std::move(value);
+        }
+        return m_size < m_buffer.size();
+    }
+
+    // Number of results written
+    std::size_t result() const { return m_size; }
+
+protected:
+    Span<T> m_buffer;
+    std::size_t m_size = 0;
+};
+
+// True if some handler returns true, stops at the first one
+class AnyOf {
+public:
+    template<class T>
+    bool collect(T &&value) {
+        m_result = static_cast<bool>(value);
+        return !m_result;
+    }
+
+    bool result() const { return m_result; }
+
+protected:
+    bool m_result = false;
+};
+
+// True if all handlers return true, stops at the first false
+class AllOf {
+public:
+    template<class T>
+    bool collect(T &&value) {
+        m_result = static_cast<bool>(value);
+        return m_result;
+    }
+
+    bool result() const { return m_result; }
+
+protected:
+    bool m_result = true;
+};
+
+} // namespace Hlk
+
+#endif // HLK_COLLECTORS_H
@@ -0,0 +1,342 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_CONCURRENT_EVENT_H
+#define HLK_CONCURRENT_EVENT_H
+
+#include "abstractevent.h"
+#include "delegate.h"
+#include "eventdispatcher.h"
+#include "notifiableobject.h"
+#include "queuedwrapper.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Hlk {
+
+/**
+ * @brief Read-mostly event that never locks on emission
+ *
+ * Handlers are kept in an immutable, reference-counted snapshot. Adding or
+ * removing a handler copies the current snapshot, modifies the copy and
+ * atomically publishes it, so any number of threads may emit concurrently
+ * without taking a lock. An emission always works with the snapshot it
+ * started with, but a handler removed during an emission in another thread,
+ * e.g. by the destruction of its notifiable object, is skipped by that
+ * emission unless its call has already begun. Its delegate stays alive until
+ * the emission finishes. Handlers may remove themselves or destroy the event.
+ *
+ * @tparam TArgs event arguments
+ */
+template <class... TArgs>
+class ConcurrentEvent : public AbstractEvent {
+    using TDelegate = Delegate<void(TArgs...)>;
+    using TQueuedWrapper = QueuedWrapper<void(TArgs...)>;
+
+    // Shared by the snapshots containing the handler
+    struct Target {
+        explicit Target(TDelegate &&delegate)
+        : delegate(std::move(delegate)) { }
+
+        TDelegate delegate;
+        std::atomic<bool> removed { false };
+    };
+
+    struct Handler {
+        std::shared_ptr<Target> target;
+        Connection connection;
+        Attachment *attachment = nullptr;
+    };
+    using THandlers = std::vector<Handler>;
+
+    struct Snapshot {
+        THandlers handlers;
+        std::atomic<unsigned int> refs { 1 };
+    };
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    ConcurrentEvent() {
+        m_snapshot.store(new Snapshot());
+    }
+
+    ConcurrentEvent(const ConcurrentEvent &other) = delete;
+    ConcurrentEvent(ConcurrentEvent && other) = delete;
+
+    ~ConcurrentEvent() {
+        std::unique_lock lock(m_writeMutex);
+        EventDispatcher::getInstance()->eventDestroyed(this);
+        releaseSnapshot(m_snapshot.load());
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Remove the event handler by its connection
+    virtual void removeEventHandler(const Connection &connection) override {
+        std::unique_lock lock(m_writeMutex);
+        unsafeRemoveAt(indexOfConnection(connection));
+    }
+
+    // Attaches function handler
+    Connection addEventHandler(void (*func)(TArgs...)) {
+        std::unique_lock lock(m_writeMutex);
+        return publishWith(TDelegate(func));
+    }
+
+    /**
+     * @brief Attaches method handler
+     *
+     * The attached class must inherit from NotifiableObject, see
+     * Event::addEventHandler
+     */
+    template<class TObject>
+    Connection addEventHandler(TObject *object, void (TObject::*method)(TArgs...)) {
+        std::unique_lock lock(m_writeMutex);
+        return publishWith(TQueuedWrapper::bind(TDelegate(object, method), object), object);
+    }
+
+    // Attaches lambda handler with no context tracking
+    template<class TLambda, class = std::enable_if_t<std::is_invocable_v<TLambda &, TArgs...>>>
+    Connection addEventHandler(TLambda && lambda) {
+        std::unique_lock lock(m_writeMutex);
+        return publishWith(TDelegate(std::forward<TLambda>(lambda)));
+    }
+
+    // Attaches lambda handler removed on context destruction
+    template<class TLambda>
+    Connection addEventHandler(NotifiableObject *context, TLambda && lambda) {
+        std::unique_lock lock(m_writeMutex);
+        return publishWith(TQueuedWrapper::bind(TDelegate(std::forward<TLambda>(lambda)), context), context);
+    }
+
+    // Remove function event handler
+    void removeEventHandler(void (*func)(TArgs...)) {
+        std::unique_lock lock(m_writeMutex);
+        unsafeRemoveAt(indexOfHandler(TDelegate(func)));
+    }
+
+    // Remove method event handler
+    template<class TObject>
+    void removeEventHandler(TObject *object, void (TObject::*method)(TArgs...)) {
+        std::unique_lock lock(m_writeMutex);
+        unsafeRemoveAt(indexOfHandler(TQueuedWrapper::bind(TDelegate(object, method), object)));
+    }
+
+    // Remove lambda event handler
+    template<class TLambda, class = std::enable_if_t<std::is_invocable_v<TLambda &, TArgs...>>>
+    void removeEventHandler(TLambda && lambda) {
+        std::unique_lock lock(m_writeMutex);
+        unsafeRemoveAt(indexOfHandler(TDelegate(std::forward<TLambda>(lambda))));
+    }
+
+    // Emits the event moving the arguments into the last handler
+    void emitMove(TArgs... params) {
+        emitHandlers<true>(params...);
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    // Every handler gets its own copy of value arguments, see Event::operator()
+    void operator()(TArgs... params) {
+        emitHandlers<false>(params...);
+    }
+
+    ConcurrentEvent& operator=(const ConcurrentEvent &other) = delete;
+    ConcurrentEvent& operator=(ConcurrentEvent && other) = delete;
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    template<bool moveToLast>
+    void emitHandlers(TArgs &... params) {
+        /* The snapshot is owned by this call until released, so neither
+        concurrent modifications nor destruction of the event by a handler
+        invalidate it */
+        Snapshot *snapshot = acquireSnapshot();
+        const THandlers &handlers = snapshot->handlers;
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            Target &target = *handlers[i].target;
+
+            // Removed after the snapshot was taken, its object may be gone
+            if (target.removed.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (moveToLast && i + 1 == handlers.size()) {
+                target.delegate.invoke(std::forward<TArgs>(params)...);
+            } else {
+                target.delegate.invoke(copyArgument<TArgs>(params)...);
+            }
+        }
+        releaseSnapshot(snapshot);
+    }
+
+    /* Readers announce themselves in the counter of the current epoch only
+    while loading the snapshot pointer and taking a reference on it. A writer
+    flips the epoch after publishing and waits for the previous epoch's
+    counter to drain, after which no reader can still be about to reference
+    the old snapshot. Waiting never covers handler execution */
+    Snapshot *acquireSnapshot() {
+        for (;;) {
+            unsigned int epoch = m_epoch.load();
+            m_readers[epoch & 1].fetch_add(1);
+            if (m_epoch.load() != epoch) {
+                m_readers[epoch & 1].fetch_sub(1);
+                continue;
+            }
+            Snapshot *snapshot = m_snapshot.load();
+            snapshot->refs.fetch_add(1, std::memory_order_relaxed);
+            m_readers[epoch & 1].fetch_sub(1, std::memory_order_release);
+            return snapshot;
+        }
+    }
+
+    static void releaseSnapshot(Snapshot *snapshot) {
+        if (snapshot->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete snapshot;
+        }
+    }
+
+    // Replaces the current snapshot, m_writeMutex must be locked
+    void publish(Snapshot *snapshot) {
+        Snapshot *old = m_snapshot.exchange(snapshot);
+        unsigned int epoch = m_epoch.fetch_add(1);
+        while (m_readers[epoch & 1].load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        releaseSnapshot(old);
+    }
+
+    // Publishes a copy with the delegate appended, unless already attached
+    Connection publishWith(TDelegate &&delegate, NotifiableObject *notifiable = nullptr) {
+        int index = indexOfHandler(delegate);
+        if (index != -1) {
+            return m_snapshot.load()->handlers[index].connection;
+        }
+
+        // Snapshot entries are never reused, so the id alone identifies them
+        Handler handler;
+        handler.target = std::make_shared<Target>(std::move(delegate));
+        handler.connection = Connection(m_nextId++, 1);
+        if (notifiable) {
+            handler.attachment = EventDispatcher::getInstance()->registerAttachment(this, notifiable, handler.connection);
+        }
+
+        const THandlers &handlers = m_snapshot.load()->handlers;
+        auto snapshot = new Snapshot();
+        snapshot->handlers.reserve(handlers.size() + 1);
+        snapshot->handlers = handlers;
+        snapshot->handlers.push_back(std::move(handler));
+        publish(snapshot);
+        return snapshot->handlers.back().connection;
+    }
+
+    // Publishes a copy without the handler at index, running emissions skip it from now on
+    void publishWithout(size_t index) {
+        const THandlers &handlers = m_snapshot.load()->handlers;
+        handlers[index].target->removed.store(true, std::memory_order_release);
+        auto snapshot = new Snapshot();
+        snapshot->handlers.reserve(handlers.size() - 1);
+        snapshot->handlers.insert(snapshot->handlers.end(), handlers.begin(), handlers.begin() + index);
+        snapshot->handlers.insert(snapshot->handlers.end(), handlers.begin() + index + 1, handlers.end());
+        publish(snapshot);
+    }
+
+    inline int indexOfHandler(const TDelegate &delegate) {
+        const THandlers &handlers = m_snapshot.load()->handlers;
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            if (handlers[i].target->delegate != delegate) {
+                continue;
+            }
+            return i;
+        }
+        return -1;
+    }
+
+    inline int indexOfConnection(const Connection &connection) {
+        const THandlers &handlers = m_snapshot.load()->handlers;
+        for (size_t i = 0; i < handlers.size(); ++i) {
+            if (handlers[i].connection != connection) {
+                continue;
+            }
+            return i;
+        }
+        return -1;
+    }
+
+    inline void unsafeRemoveAt(int index) {
+        if (index == -1) {
+            return;
+        }
+        if (Attachment *attachment = m_snapshot.load()->handlers[index].attachment) {
+            EventDispatcher::getInstance()->removeAttachment(attachment);
+        }
+        publishWithout(index);
+    }
+
+    virtual bool tryLockHandlers() override {
+        return m_writeMutex.try_lock();
+    }
+
+    virtual void unlockHandlers() override {
+        m_writeMutex.unlock();
+    }
+
+    virtual Attachment *&attachments() override {
+        return m_attachments;
+    }
+
+    // Remove the handler without touching its attachment
+    virtual void unsafeRemoveEventHandler(const Connection &connection) override {
+        int index = indexOfConnection(connection);
+        if (index != -1) {
+            publishWithout(index);
+        }
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::atomic<Snapshot *> m_snapshot { nullptr };
+    std::atomic<unsigned int> m_epoch { 0 };
+    std::atomic<unsigned int> m_readers[2] { { 0 }, { 0 } };
+    std::mutex m_writeMutex;
+    Attachment *m_attachments = nullptr;
+    uint32_t m_nextId = 0;
+};
+
+} // namespace Hlk
+
+#endif // HLK_CONCURRENT_EVENT_H
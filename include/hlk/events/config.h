@@ -0,0 +1,38 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_EVENTS_CONFIG_H
+#define HLK_EVENTS_CONFIG_H
+
+/* With HLK_EVENTS_HEADER_ONLY defined the sources are included by the headers 
+and their definitions are made inline, so no library has to be linked */
+#ifdef HLK_EVENTS_HEADER_ONLY
+#define HLK_EVENTS_INLINE inline
+#else
+#define HLK_EVENTS_INLINE
+#endif
+
+/* With HLK_EVENTS_INSTRUMENTATION defined events record their emissions, 
+handler latencies and lock waits, see instrumentation.h. It must be defined 
+for the library and every translation unit using it */
+
+#endif // HLK_EVENTS_CONFIG_H
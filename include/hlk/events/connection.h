@@ -0,0 +1,86 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_CONNECTION_H
+#define HLK_CONNECTION_H
+
+#include <cstdint>
+
+namespace Hlk {
+
+/**
+ * @brief Token identifying an attached event handler
+ * 
+ * Returned by addEventHandler() and accepted by removeEventHandler(). 
+ * Consists of the slot index of the handler and the generation of the slot, 
+ * so a token of a removed handler never matches a handler which reused the 
+ * slot. A default constructed connection is invalid.
+ */
+class Connection {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    Connection() = default;
+
+    Connection(uint32_t index, uint32_t generation) 
+    : m_index(index),
+      m_generation(generation) { }
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    uint32_t index() const { return m_index; }
+    uint32_t generation() const { return m_generation; }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    bool isValid() const { return m_generation != 0; }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    inline bool operator==(const Connection &other) const {
+        return m_index == other.m_index && m_generation == other.m_generation;
+    }
+
+    inline bool operator!=(const Connection &other) const {
+        return !(*this == other);
+    }
+
+protected:
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    uint32_t m_index = 0;
+    uint32_t m_generation = 0;
+};
+
+} // namespace Hlk
+
+#endif // HLK_CONNECTION_H
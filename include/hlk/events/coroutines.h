@@ -0,0 +1,431 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_COROUTINES_H
+#define HLK_COROUTINES_H
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error "hlk/events/coroutines.h requires C++20 coroutines"
+#endif
+
+#include "event.h"
+
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Hlk {
+
+/**
+ * @brief Base of the coroutine awaitables, owns a handler of the event
+ * 
+ * The handler is a wrapper pointing back to the waiter. Whichever side dies 
+ * first unlinks the other: the waiter removes the handler, the destroyed 
+ * handler tells the waiter its event is gone. A handler attached to resume 
+ * once shares a flag with its copies which concurrent emissions race for 
+ * before they touch the waiter, so the resumed coroutine may destroy the 
+ * waiter while the losing emissions are still running. Otherwise waiters 
+ * must not be destroyed concurrently with an emission of their event in 
+ * another thread.
+ */
+template<class... TArgs>
+class EventWaiter {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    // Arguments of an emission, references are stored as values
+    using TResult = std::tuple<std::decay_t<TArgs>...>;
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    EventWaiter() = default;
+
+    // The handler points to the waiter, so it can't be copied or moved
+    EventWaiter(const EventWaiter &other) = delete;
+
+    virtual ~EventWaiter() = default;
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    EventWaiter& operator=(const EventWaiter &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    using TDelegate = Delegate<void(TArgs...)>;
+
+    class Wrapper : public AbstractWrapper<void(TArgs...)> {
+    public:
+        Wrapper(EventWaiter *waiter, bool once) 
+        : m_waiter(waiter),
+          m_once(once) {
+            this->m_tag = this->template typeTag<Wrapper>();
+            this->m_hash = this->hashBytes(&m_waiter, sizeof(m_waiter), 
+                reinterpret_cast<std::size_t>(this->m_tag));
+        }
+
+        // Copies of handlers, e.g. in a copied event, don't wake the waiter
+        Wrapper(const Wrapper &other) 
+        : AbstractWrapper<void(TArgs...)>(other) { }
+
+        Wrapper(Wrapper&& other) noexcept
+        : AbstractWrapper<void(TArgs...)>(other),
+          m_waiter(other.m_waiter),
+          m_once(other.m_once),
+          m_fired(other.m_fired.load(std::memory_order_relaxed)) {
+            other.m_waiter = nullptr;
+        }
+
+        // Destroyed with the event or after detach()
+        virtual ~Wrapper() {
+            if (m_waiter) {
+                m_waiter->onEventDestroyed();
+            }
+        }
+
+        virtual AbstractWrapper<void(TArgs...)> *clone(void *storage) const override {
+            return this->template emplace<Wrapper>(storage, *this);
+        }
+
+        virtual AbstractWrapper<void(TArgs...)> *move(void *storage) override {
+            return this->template relocate<Wrapper>(storage, *this);
+        }
+
+        virtual void destroy() override {
+            this->template dispose<Wrapper>(this);
+        }
+
+        void detach() { m_waiter = nullptr; }
+
+        virtual void operator()(TArgs&&... args) override {
+            // Only the emission setting the flag may reach the waiter
+            if (m_once && m_fired.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+            if (m_waiter) {
+                m_waiter->onEmission(std::forward<TArgs>(args)...);
+            }
+        }
+
+    protected:
+        virtual bool isEquals(const AbstractWrapper<void(TArgs...)> &other) const override {
+            return m_waiter == static_cast<const Wrapper &>(other).m_waiter;
+        }
+
+        EventWaiter *m_waiter = nullptr;
+
+        /* Set by the first emission of a handler resuming once. Emissions call 
+        the handler in its slot, which stays until the last emission ends */
+        bool m_once = false;
+        std::atomic<bool> m_fired { false };
+    };
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    /* Chooses the event attach() adds the handler to. The event type, and so 
+    its threading policy, is kept in the functions attaching and detaching */
+    template<class TEvent>
+    void setTarget(TEvent &event) {
+        m_target = &event;
+        m_attach = &attachTo<TEvent>;
+        m_detach = &detachFrom<TEvent>;
+    }
+
+    // Adds the handler, once makes concurrent emissions call onEmission() only once
+    void attach(bool once = false) {
+        m_attach(this, once);
+    }
+
+    // Removes the handler, does nothing if the event is gone
+    void detach() {
+        if (m_event == nullptr) {
+            return;
+        }
+        m_detach(this);
+        m_event = nullptr;
+    }
+
+    // Called by the handler on emission, the event isn't locked
+    virtual void onEmission(TArgs&&... args) = 0;
+
+    // Called when the handler is destroyed together with the event
+    virtual void onEventDestroyed() {
+        m_event = nullptr;
+    }
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    template<class TEvent>
+    static void attachTo(EventWaiter *waiter, bool once) {
+        auto event = static_cast<TEvent *>(waiter->m_target);
+        TDelegate delegate;
+        delegate.template emplace<Wrapper>(waiter, once);
+
+        std::unique_lock lock(event->state()->mutex);
+        waiter->m_connection = event->unsafeAddEventHandler(std::move(delegate));
+        waiter->m_event = event;
+    }
+
+    template<class TEvent>
+    static void detachFrom(EventWaiter *waiter) {
+        auto event = static_cast<TEvent *>(waiter->m_event);
+        typename TEvent::State *state = event->currentState();
+        std::unique_lock lock(state->mutex);
+
+        /* The handler may outlive the removal if the event is emitting, so it 
+        forgets the waiter first */
+        if (TDelegate *delegate = state->handlers.get(waiter->m_connection)) {
+            if (Wrapper *wrapper = delegate->template target<Wrapper>()) {
+                wrapper->detach();
+            }
+        }
+        event->unsafeRemoveConnection(waiter->m_connection);
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    // Event chosen by setTarget() and the event the handler is attached to
+    AbstractEvent *m_target = nullptr;
+    AbstractEvent *m_event = nullptr;
+    void (*m_attach)(EventWaiter *, bool) = nullptr;
+    void (*m_detach)(EventWaiter *) = nullptr;
+    Connection m_connection;
+};
+
+/**
+ * @brief Awaitable of the next emission of an event
+ * 
+ * Returned by Event::next(). The awaiter lives in the coroutine frame and 
+ * its handler fits the inline storage of the delegate together with the 
+ * flag deciding which of concurrent emissions resumes the coroutine, so 
+ * waiting doesn't allocate. The coroutine is resumed by the emitting thread 
+ * with the arguments as a tuple. If the event is destroyed first, the 
+ * coroutine stays suspended and may be destroyed safely.
+ */
+template<class... TArgs>
+class EventAwaiter : public EventWaiter<TArgs...> {
+public:
+    using typename EventWaiter<TArgs...>::TResult;
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    template<class TEvent, class = std::enable_if_t<std::is_base_of_v<AbstractEvent, TEvent>>>
+    explicit EventAwaiter(TEvent &event) {
+        this->setTarget(event);
+    }
+
+    virtual ~EventAwaiter() {
+        this->detach();
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        m_handle = handle;
+        this->attach(true);
+    }
+
+    TResult await_resume() {
+        return std::move(*m_result);
+    }
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Reached by one emission only, see EventWaiter
+    virtual void onEmission(TArgs&&... args) override {
+        m_result.emplace(std::forward<TArgs>(args)...);
+        this->detach();
+        m_handle.resume();
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::coroutine_handle<> m_handle;
+    std::optional<TResult> m_result;
+};
+
+/**
+ * @brief Asynchronous sequence of the emissions of an event
+ * 
+ * Returned by Event::emissions(). Collects every emission from its creation 
+ * on, `co_await stream.next()` returns the oldest one as an optional tuple, 
+ * or std::nullopt once the event is destroyed and the collected emissions 
+ * are consumed:
+ * 
+ *     auto stream = event.emissions();
+ *     while (auto args = co_await stream.next()) { ... }
+ * 
+ * An emission reaching a suspended consumer is handed over and resumes it 
+ * without allocation, emissions arriving while the consumer is busy are 
+ * queued. Only one coroutine may await the stream at a time.
+ */
+template<class... TArgs>
+class EventStream : public EventWaiter<TArgs...> {
+public:
+    using typename EventWaiter<TArgs...>::TResult;
+
+    class Awaiter {
+    public:
+        explicit Awaiter(EventStream &stream) 
+        : m_stream(&stream) { }
+
+        bool await_ready() {
+            std::unique_lock lock(m_stream->m_mutex);
+            return take();
+        }
+
+        // Doesn't suspend if an emission arrived after await_ready()
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::unique_lock lock(m_stream->m_mutex);
+            if (take()) {
+                return false;
+            }
+            m_handle = handle;
+            m_stream->m_waiting = this;
+            return true;
+        }
+
+        std::optional<TResult> await_resume() {
+            return std::move(m_result);
+        }
+
+    private:
+        friend class EventStream;
+
+        // Takes a collected emission, true if there is no need to wait
+        bool take() {
+            if (!m_stream->m_pending.empty()) {
+                m_result.emplace(std::move(m_stream->m_pending.front()));
+                m_stream->m_pending.pop_front();
+                return true;
+            }
+            return m_stream->m_event == nullptr;
+        }
+
+        EventStream *m_stream;
+        std::coroutine_handle<> m_handle;
+        std::optional<TResult> m_result;
+    };
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    template<class TEvent, class = std::enable_if_t<std::is_base_of_v<AbstractEvent, TEvent>>>
+    explicit EventStream(TEvent &event) {
+        this->setTarget(event);
+        this->attach();
+    }
+
+    virtual ~EventStream() {
+        this->detach();
+    }
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    // Emissions collected and not yet awaited
+    size_t pending() {
+        std::unique_lock lock(m_mutex);
+        return m_pending.size();
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    Awaiter next() {
+        return Awaiter(*this);
+    }
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    virtual void onEmission(TArgs&&... args) override {
+        std::unique_lock lock(m_mutex);
+        if (m_waiting == nullptr) {
+            m_pending.emplace_back(std::forward<TArgs>(args)...);
+            return;
+        }
+
+        Awaiter *waiting = std::exchange(m_waiting, nullptr);
+        waiting->m_result.emplace(std::forward<TArgs>(args)...);
+        lock.unlock();
+        waiting->m_handle.resume();
+    }
+
+    // Ends the stream, a suspended consumer is resumed with std::nullopt
+    virtual void onEventDestroyed() override {
+        std::unique_lock lock(m_mutex);
+        this->m_event = nullptr;
+        Awaiter *waiting = std::exchange(m_waiting, nullptr);
+        lock.unlock();
+        if (waiting) {
+            waiting->m_handle.resume();
+        }
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::mutex m_mutex;
+    std::deque<TResult> m_pending;
+    Awaiter *m_waiting = nullptr;
+};
+
+} // namespace Hlk
+
+#endif // HLK_COROUTINES_H
@@ -27,7 +27,12 @@
 #include "functionwrapper.h"
 #include "methodwrapper.h"
 #include "lambdawrapper.h"
+#include "weakmethodwrapper.h"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 namespace Hlk {
@@ -37,6 +42,7 @@ class Delegate;
 
 template<class TReturn, class... TArgs>
 class Delegate<TReturn(TArgs...)> : public AbstractDelegate {
+    using TWrapper = AbstractWrapper<TReturn(TArgs...)>;
 public:
     /**************************************************************************
      * Constructors / Destructors
@@ -55,25 +61,32 @@ public:
         bind(object, method);
     }
 
+    // Auto-bind constructor of a method of an object owned by std::shared_ptr
+    template<class TClass>
+    Delegate(const std::weak_ptr<TClass> &object, TReturn (TClass::*method)(TArgs...)) {
+        bind(object, method);
+    }
+
     // Auto-bind lambda constructor
-    template<class TLambda>
+    template<class TLambda, class = std::enable_if_t<!std::is_same_v<std::decay_t<TLambda>, Delegate>>>
     Delegate(TLambda && lambda) { 
-        bind(std::move(lambda)); 
+        bind(std::forward<TLambda>(lambda)); 
     }
 
     // Copy constructor
     Delegate(const Delegate &other) { 
-        m_wrapper = other.m_wrapper->clone(); 
+        if (other.m_wrapper) {
+            m_wrapper = other.m_wrapper->clone(&m_storage);
+        }
     }
 
     // Move constructor
-    Delegate(Delegate && other) {
-        m_wrapper = other.m_wrapper;
-        other.m_wrapper = nullptr;
+    Delegate(Delegate && other) noexcept {
+        steal(other);
     }
 
     ~Delegate() { 
-        delete m_wrapper; 
+        reset();
     }
 
     /**************************************************************************
@@ -82,30 +95,86 @@ public:
 
     // Bind function
     void bind(TReturn (*func)(TArgs...)) {
-        if (m_wrapper) {
-            delete m_wrapper;
-        }
-        m_wrapper = new FunctionWrapper<TReturn(TArgs...)>(func);
+        reset();
+        m_wrapper = TWrapper::template emplace<FunctionWrapper<TReturn(TArgs...)>>(&m_storage, func);
     }
 
     // Bind method
     template<class TClass>
     void bind(TClass *object, TReturn (TClass::*method)(TArgs...)) {
-        if (m_wrapper) {
-            delete m_wrapper;
-        }
-        m_wrapper = new MethodWrapper<TClass, TReturn(TArgs...)>(object, method);
+        reset();
+        m_wrapper = TWrapper::template emplace<MethodWrapper<TClass, TReturn(TArgs...)>>(&m_storage, object, method);
+    }
+
+    // Bind method of an object held by a weak reference, see WeakMethodWrapper
+    template<class TClass>
+    void bind(const std::weak_ptr<TClass> &object, TReturn (TClass::*method)(TArgs...)) {
+        reset();
+        m_wrapper = TWrapper::template emplace<WeakMethodWrapper<TClass, TReturn(TArgs...)>>(
+            &m_storage, object, method
+        );
     }
 
     // Bind lambda
     template<class TLambda>
     void bind(TLambda&& lambda) {
-        if (m_wrapper) {
-            delete m_wrapper;
+        reset();
+        m_wrapper = TWrapper::template emplace<LambdaWrapper<std::decay_t<TLambda>, TReturn(TArgs...)>>(
+            &m_storage, std::forward<TLambda>(lambda)
+        );
+    }
+
+    // Bind a wrapper of the given type constructed from the arguments
+    template<class TConcrete, class... TCtorArgs>
+    void emplace(TCtorArgs &&... args) {
+        reset();
+        m_wrapper = TWrapper::template emplace<TConcrete>(&m_storage, std::forward<TCtorArgs>(args)...);
+    }
+
+    // The wrapper if it is of the given type, nullptr otherwise
+    template<class TConcrete>
+    TConcrete *target() {
+        if (!m_wrapper || m_wrapper->tag() != TWrapper::template typeTag<TConcrete>()) {
+            return nullptr;
+        }
+        return static_cast<TConcrete *>(m_wrapper);
+    }
+
+    // Unbind and destroy the wrapper
+    void reset() {
+        if (!m_wrapper) {
+            return;
+        }
+        m_wrapper->destroy();
+        m_wrapper = nullptr;
+    }
+
+    /**
+     * @brief Calls the target forwarding the arguments
+     * 
+     * Value arguments are taken by rvalue reference and moved into the 
+     * target, references are passed through, so no argument is copied.
+     */
+    TReturn invoke(TArgs&&... args) {
+        if (!m_wrapper) {
+            return TReturn();
         }
-        auto wrapper = new LambdaWrapper<TLambda, TReturn(TArgs...)>();
-        wrapper->bind(std::move(lambda));
-        m_wrapper = wrapper;
+        return m_wrapper->operator()(std::forward<TArgs>(args)...);
+    }
+
+    // Hash of the bound target, equal delegates have equal hashes
+    inline std::size_t hash() const {
+        return m_wrapper ? m_wrapper->hash() : 0;
+    }
+
+    // True if the target is gone, calls then do nothing
+    inline bool expired() const {
+        return m_wrapper && m_wrapper->expired();
+    }
+
+    // True if the wrapper is placed in the inline storage instead of the heap
+    inline bool isInline() const {
+        return static_cast<const void *>(m_wrapper) == static_cast<const void *>(&m_storage);
     }
 
     /**************************************************************************
@@ -113,10 +182,7 @@ public:
      *************************************************************************/
 
     TReturn operator()(TArgs... args) {
-        if (!m_wrapper) {
-            return TReturn();
-        }
-        return m_wrapper->operator()(args...);
+        return invoke(std::forward<TArgs>(args)...);
     }
 
     // Copy assignment operator
@@ -124,36 +190,72 @@ public:
         if (this == &other) {
             return *this;
         }
-        m_wrapper = other.m_wrapper->clone();
+        reset();
+        if (other.m_wrapper) {
+            m_wrapper = other.m_wrapper->clone(&m_storage);
+        }
         return *this;
     };
 
     // Move assignment operator
-    Delegate& operator=(Delegate && other) {
+    Delegate& operator=(Delegate && other) noexcept {
         if (this == &other) {
             return *this;
         }
-        m_wrapper = other.m_wrapper;
-        other.m_wrapper = nullptr;
+        reset();
+        steal(other);
         return *this;
     }
 
     inline bool operator==(const Delegate<TReturn(TArgs...)> &other) const {
+        if (!m_wrapper || !other.m_wrapper) {
+            return m_wrapper == other.m_wrapper;
+        }
         return *m_wrapper == *(other.m_wrapper);
     }
 
     inline bool operator!=(const Delegate<TReturn(TArgs...)> &other) const {
-        return *m_wrapper != *(other.m_wrapper);
+        return !(*this == other);
     }
 
 protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Takes the wrapper of other, this delegate must be empty before the call
+    inline void steal(Delegate &other) noexcept {
+        if (!other.m_wrapper) {
+            return;
+        }
+        m_wrapper = other.m_wrapper->move(&m_storage);
+        if (m_wrapper == other.m_wrapper) {
+            // Heap wrapper, only the ownership is transferred
+            other.m_wrapper = nullptr;
+            return;
+        }
+        other.reset();
+    }
+
     /**************************************************************************
      * Members
      *************************************************************************/
 
-    AbstractWrapper<TReturn(TArgs...)> *m_wrapper = nullptr;
+    TWrapper *m_wrapper = nullptr;
+    std::aligned_storage_t<TWrapper::inlineStorageSize, TWrapper::inlineStorageAlign> m_storage;
 };
 
 } // namespace Hlk
 
+namespace std {
+
+template<class TReturn, class... TArgs>
+struct hash<Hlk::Delegate<TReturn(TArgs...)>> {
+    size_t operator()(const Hlk::Delegate<TReturn(TArgs...)> &delegate) const noexcept {
+        return delegate.hash();
+    }
+};
+
+} // namespace std
+
 #endif // HLK_DELEGATE_H
\ No newline at end of file
@@ -23,356 +23,415 @@
 #ifndef HLK_EVENT_H
 #define HLK_EVENT_H
 
-#include "abstractevent.h"
-#include "delegate.h"
-#include "eventdispatcher.h"
+#include "basicevent.h"
+#include "batchwrapper.h"
+#include "collectors.h"
+#include "threadpool.h"
 
+#include <memory>
 #include <mutex>
-#include <vector>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 
 namespace Hlk {
 
-template <class... TArgs>
-class Event : public AbstractEvent {
+class EventQueue;
+
+template<class... TArgs>
+class EventAwaiter;
+
+template<class... TArgs>
+class EventStream;
+
+template<class... TArgs>
+class EventWaiter;
+
+template<class... TArgs>
+class Event;
+
+/**
+ * @brief Event with the threading policy given as its first argument
+ * 
+ * Event<TArgs...> is Event<MultiThreaded, TArgs...>. Events touched by one 
+ * thread only skip locking with Event<SingleThreaded, TArgs...>, 
+ * SingleThreadedUntracked also skips EventDispatcher, the handlers of 
+ * destroyed notifiable objects must then be removed by hand. FutexLocked 
+ * and SpinLocked keep the event thread-safe with a lock of one word or one 
+ * byte, see threadingpolicy.h. Asynchronous and parallel emissions call 
+ * the handlers on other threads, so events using them need a lock.
+ * 
+ * @tparam TMutex lock of the handlers
+ * @tparam trackObjects whether handlers of destroyed notifiable objects are 
+ * removed
+ * @tparam TArgs event arguments
+ */
+template<class TMutex, bool trackObjects, class... TArgs>
+class Event<ThreadingPolicy<TMutex, trackObjects>, TArgs...>
+    : public BasicEvent<void(TArgs...), ThreadingPolicy<TMutex, trackObjects>> {
+    friend class EventQueue;
+    friend class EventWaiter<TArgs...>;
+
+    using TBase = BasicEvent<void(TArgs...), ThreadingPolicy<TMutex, trackObjects>>;
     using TDelegate = Delegate<void(TArgs...)>;
+    using TBatchWrapper = BatchWrapper<void(TArgs...)>;
+    using TBatch = typename TBatchWrapper::TBatch;
+    using TBatchDelegate = typename TBatchWrapper::TBatchDelegate;
+    using TArguments = std::tuple<std::decay_t<TArgs>...>;
+    using typename TBase::AsyncState;
+    using typename TBase::State;
 public:
     /**************************************************************************
      * Constructors / Destructors
      *************************************************************************/
 
-    Event() {
-        // Create mutex
-        m_mutex = new std::mutex();
-
-        // Create empty event handler collection
-        m_handlers = new std::vector<TDelegate *>();
-    }
-
-    Event(const Event &other) { 
-        // Create mutex
-        m_mutex = new std::mutex();
-        
-        // Copy handlers
-        m_handlers = new std::vector<TDelegate *>();
-        for (size_t i = 0; i < other.m_handlers->size(); ++i) {
-            m_handlers->push_back((*other.m_handlers)[i]);
-        }
-    }
+    Event() = default;
 
-    Event(Event && other) 
-    : m_destroyed(other.m_destroyed),
-      m_called(other.m_called)  {
-        // Create mutex
-        m_mutex = new std::mutex();
+    Event(const Event &other) 
+    : TBase(other) { }
 
-        // Move handlers
-        m_handlers = other.m_handlers;
-        other.m_handlers = nullptr;
+    // Pending asynchronous emissions and the executor follow the handlers
+    Event(Event && other)
+    : TBase(std::move(other)) {
+        setAsyncEvent(this);
     }
 
     ~Event() {
-        m_mutex->lock();
-        /* The event is currently being processed. Some event handler caused the 
-        deletion of the object containing the event */
-        if (m_called) {
-            m_destroyed = 1;                    
-            m_mutex->unlock();
-            return;
-        }
-
-        // Delete event handlers
-        for (TDelegate *delegate : *m_handlers) {
-            delete delegate;
-        }
-        delete m_handlers;
-        m_handlers = nullptr;
-
-        m_mutex->unlock();
-
-        // Delete mutex
-        delete m_mutex;
-        m_mutex = nullptr;
-
-        EventDispatcher::getInstance()->eventDestroyed(this);
+        // Drop not yet executed asynchronous emissions
+        setAsyncEvent(nullptr);
     }
 
     /**************************************************************************
      * Methods
      *************************************************************************/
 
-    virtual void removeEventHandler(AbstractDelegate *delegate) override {
-        removeEventHandler(dynamic_cast<TDelegate *>(delegate));
-    }
-
-    // Remove event handler, safe
-    void removeEventHandler(TDelegate *delegate) {
-        std::unique_lock lock(*m_mutex);
-        int index = indexOfHandler(delegate);
-        if (index == -1) {
-            return;
-        }
-        delete (*m_handlers)[index];
-        if (m_called) {
-            (*m_handlers)[index] = nullptr;
-            ++m_deletedHandlersCounter;
-            return;
-        }
-        m_handlers->erase(m_handlers->begin() + index);
-    }
-
     /**
-     * @brief Creates function delegate and attaches it to the Event
+     * @brief Attaches function handler taking a whole batch of emissions
      * 
-     * @param func attached function
+     * Batch handlers get the items of emitBatch() in one call, as a 
+     * Span<const T> for a single argument T or as a span of tuples of the 
+     * arguments. Ordinary emissions are passed as a batch of one item.
      */
-    void addEventHandler(void (*func)(TArgs...)) {
-        std::unique_lock lock(*m_mutex);
+    Connection addBatchHandler(void (*func)(TBatch)) {
+        std::unique_lock lock(this->state()->mutex);
+        return unsafeAddEventHandler(makeBatchDelegate(TBatchDelegate(func)));
+    }
 
-        // Create delegate for handle function
-        auto delegate = new TDelegate(func);
+    // Attaches method batch handler, see addBatchHandler(void (*)(TBatch))
+    template<class TObject>
+    Connection addBatchHandler(TObject *object, void (TObject::*method)(TBatch)) {
+        std::unique_lock lock(this->state()->mutex);
+        return unsafeAddEventHandler(makeBatchDelegate(TBatchDelegate(object, method)), object);
+    }
 
-        // Try to find some delegate in std::vector
-        if (indexOfHandler(delegate) != -1) {
-            delete delegate;
-            return;
-        }
+    // Attaches lambda batch handler, see addBatchHandler(void (*)(TBatch))
+    template<class TLambda, class = std::enable_if_t<std::is_invocable_v<TLambda &, TBatch>>>
+    Connection addBatchHandler(TLambda && lambda) {
+        std::unique_lock lock(this->state()->mutex);
+        return unsafeAddEventHandler(makeBatchDelegate(TBatchDelegate(std::forward<TLambda>(lambda))));
+    }
 
-        // Append delegate to the std::vector
-        m_handlers->push_back(delegate);
+    // Attaches lambda batch handler which is removed when the context is destroyed
+    template<class TLambda>
+    Connection addBatchHandler(NotifiableObject *context, TLambda && lambda) {
+        std::unique_lock lock(this->state()->mutex);
+        return unsafeAddEventHandler(makeBatchDelegate(TBatchDelegate(std::forward<TLambda>(lambda))), context);
     }
 
     /**
-     * @brief Creates method delegate and attaches it to the Event
+     * @brief Sets the executor used by asynchronous emissions
      * 
-     * The attached class must inherit from NotifiableObject. This is necessary 
-     * to store all registered events (including communication with the object 
-     * and delegate) in the process, which, in turn, allows you to remove 
-     * handlers of destroyed objects from events.
-     * 
-     * @tparam TObject attached Class
-     * @param object attached Object
-     * @param method attached Method
+     * @param executor executor, nullptr to use ThreadPool::getInstance(). 
+     * Must outlive the event or all its asynchronous emissions
      */
-    template<class TObject>
-    void addEventHandler(TObject *object, void (TObject::*method)(TArgs...)) {
-        std::unique_lock lock(*m_mutex);
-
-        // Create delegate for handle method
-        auto delegate = new TDelegate();
-        delegate->bind(object, method);
-
-        // Try to find some delegate in std::vector
-        if (indexOfHandler(delegate) != -1) {
-            delete delegate;
-            return;
-        }
-
-        // Append delegate to the std::vector
-        m_handlers->push_back(delegate);
-
-        EventDispatcher::getInstance()->registerAttachment(this, object, m_handlers->back());
+    void setExecutor(AbstractExecutor *executor) {
+        State *state = this->state();
+        std::unique_lock lock(state->mutex);
+        state->executor = executor;
     }
 
     /**
-     * @brief Creates lambda delegate and attaches it to the Event
+     * @brief Emits the event on the executor and returns immediately
      * 
-     * Attaches a lambda to the Event with no context tracking. This means that 
-     * calling a lambda with a lambda-capture can cause undefined behavior. For 
-     * example, if instead of attaching to a method event, a lambda was attached 
-     * with a captured "this", deleting the event handler object would not 
-     * remove the lambda handler from the event, so the lambda could refer to an 
-     * invalid "this" capture or be an invalid lambda reference.
-     * 
-     * @tparam TLambda lambda template
-     * @param lambda attached lambda object
+     * Arguments are stored in the task. The handlers attached at the moment 
+     * the task is executed are called, if the event is destroyed before that, 
+     * the emission is dropped. Asynchronous emissions of the same event don't 
+     * run concurrently with each other.
      */
-    template<class TLambda>
-    void addEventHandler(TLambda && lambda) {
-        std::unique_lock lock(*m_mutex);
-
-        // Create delegate for handle lambda
-        auto delegate = new TDelegate();
-        delegate->bind(std::move(lambda));
-
-        // Try to find some delegate in std::vector
-        if (indexOfHandler(delegate) != -1) {
-            delete delegate;
-            return;
+    void emitAsync(TArgs... params) {
+        State *eventState = this->state();
+        std::unique_lock lock(eventState->mutex);
+        AbstractExecutor *executor = eventState->executor ? eventState->executor : ThreadPool::getInstance();
+        std::shared_ptr<AsyncState> state = unsafeAsyncState();
+        lock.unlock();
+
+        // Tasks must be copyable, move-only arguments are shared instead
+        if constexpr (std::is_copy_constructible_v<TArguments>) {
+            executor->execute([state, args = TArguments(std::forward<TArgs>(params)...)] () mutable {
+                emitDeferred(*state, args);
+            });
+        } else {
+            auto args = std::make_shared<TArguments>(std::forward<TArgs>(params)...);
+            executor->execute([state, args] () {
+                emitDeferred(*state, *args);
+            });
         }
+    }
 
-        // Append delegate to the std::vector
-        m_handlers->push_back(delegate);
+    /**
+     * @brief Emits the event moving the arguments into the last handler
+     * 
+     * Other handlers get copies as with operator().
+     */
+    void emitMove(TArgs... params) {
+        emitHandlers<true>(params...);
     }
 
-    template<class TLambda>
-    void addEventHandler(NotifiableObject *context, TLambda && lambda) {
-        std::unique_lock lock(*m_mutex);
+    /**
+     * @brief Emits the event running the handlers in parallel, waits for them
+     * 
+     * Independent CPU-heavy handlers run on the executor of the event and the 
+     * calling thread at once, so the emission takes about as long as the 
+     * slowest chunk of handlers instead of all of them together, see 
+     * BasicEvent::forEachHandlerParallel(). Handlers must be safe to run 
+     * concurrently. Every handler gets its own copy of value arguments, 
+     * references are shared between the threads. Handlers of objects bound 
+     * to an EventLoop are posted to it and not waited for.
+     */
+    void emitParallel(TArgs... params) {
+        static_assert(((!std::is_rvalue_reference_v<TArgs> 
+            && (std::is_lvalue_reference_v<TArgs> || std::is_copy_constructible_v<TArgs>)) && ...),
+            "Parallel emission requires copyable value or lvalue reference arguments");
+
+        auto invoke = [&params...] (TDelegate &delegate) {
+            delegate.invoke(AbstractEvent::copyArgument<TArgs>(params)...);
+        };
+        this->forEachHandlerParallel(invoke);
+    }
 
-        // Create delegate for handle lambda
-        auto delegate = new TDelegate();
-        delegate->bind(std::move(lambda));
+    /**
+     * @brief Emits the event once for every item of the batch
+     * 
+     * The lock is taken and the handlers are walked once per batch: batch 
+     * handlers get the whole batch, other handlers are called for every item 
+     * before the next handler is called. A handler removed during the batch 
+     * still gets the rest of the batch it is processing.
+     * 
+     * @param batch values for a single argument event, tuples of the 
+     * arguments otherwise
+     */
+    void emitBatch(TBatch batch) {
+        static_assert(((!std::is_reference_v<TArgs> || std::is_const_v<std::remove_reference_t<TArgs>>) && ...),
+            "Batch emission requires value or const reference arguments");
 
-        // Try to find some delegate in std::vector
-        if (indexOfHandler(delegate) != -1) {
-            delete delegate;
+        if (batch.empty()) {
             return;
         }
 
-        // Append delegate to the std::vector
-        m_handlers->push_back(delegate);
-        
-        EventDispatcher::getInstance()->registerAttachment(this, context, m_handlers->back());
-    }
-
-    // Remove function event handler
-    void removeEventHandler(void (*func)(TArgs...)) {
-        std::unique_lock lock(*m_mutex);
-        TDelegate delegate(func);
-        unsafeRemoveEventHandler(&delegate);
+        this->forEachHandler([&batch] (TDelegate &delegate) {
+            if (TBatchWrapper *batchWrapper = delegate.template target<TBatchWrapper>()) {
+                batchWrapper->invokeBatch(batch);
+                return;
+            }
+            for (const auto &item : batch) {
+                invokeItem(delegate, item);
+            }
+        });
     }
 
-    // Remove method event handler
-    template<class TObject>
-    void removeEventHandler(TObject *object, void (TObject::*method)(TArgs...)) {
-        std::unique_lock lock(*m_mutex);
-        TDelegate delegate(object, method);
-        unsafeRemoveEventHandler(&delegate);
+    /**
+     * @brief Awaitable of the next emission, requires coroutines.h and C++20
+     * 
+     * `co_await event.next()` suspends the coroutine until the next emission 
+     * and returns a tuple of its arguments, see EventAwaiter.
+     */
+    template<class TAwaiter = EventAwaiter<TArgs...>>
+    TAwaiter next() {
+        return TAwaiter(*this);
     }
 
-    // Remove lambda event handler
-    template<class TLambda>
-    void removeEventHandler(TLambda && lambda) {
-        std::unique_lock lock(*m_mutex);
-        TDelegate delegate(std::move(lambda));
-        unsafeRemoveEventHandler(&delegate);
+    /**
+     * @brief Stream of all emissions, requires coroutines.h and C++20
+     * 
+     * Emissions are collected from the call on and awaited one by one with 
+     * `co_await stream.next()`, see EventStream.
+     */
+    template<class TStream = EventStream<TArgs...>>
+    TStream emissions() {
+        return TStream(*this);
     }
 
     /**************************************************************************
      * Overloaded operators
      *************************************************************************/
 
+    /**
+     * @brief Emits the event, asynchronously if async is true, see emitAsync()
+     * 
+     * Every handler gets its own copy of value arguments, references are 
+     * passed through. Move-only values can't be copied and are moved, so 
+     * only the first handler taking them by value receives them. Handlers 
+     * attached during the emission are called from the next one.
+     */
     void operator()(TArgs... params, bool async = false) {
-        // Lock to avoid append or delete event handlers
-        std::unique_lock lock(*m_mutex);
-
-        // Already deleted
-        if (m_destroyed) {
+        if (async) {
+            emitAsync(std::forward<TArgs>(params)...);
             return;
         }
+        emitHandlers<false>(params...);
+    }
 
-        m_called = 1;
+    // Copy assignment operator, the executor is not copied
+    Event& operator=(const Event &other) {
+        TBase::operator=(other);
+        return *this;
+    }
 
-        /* If the handler removes the event, pointers to the allocated objects 
-        will be invalid. To avoid the error of freeing non-existent resources, 
-        needed to copy the pointers to the local scope of the function. */
-        std::vector<TDelegate *> *handlers = m_handlers;
-        std::mutex *mutex = m_mutex;
+protected:
+    using TBase::unsafeAddEventHandler;
 
-        for (size_t i = 0; i < handlers->size(); ++i) {
-            // Check that the event handler hasn't been deleted
-            if ((*handlers)[i] == nullptr) {
-                handlers->erase(handlers->begin() + i--);
-                continue;
-            }
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
 
-            lock.unlock();
-            (*handlers)[i]->operator()(params...);
-            lock.lock();
+    // State of deferred emissions, created on first use, the mutex must be locked
+    std::shared_ptr<AsyncState> unsafeAsyncState() {
+        State *state = this->currentState();
+        if (!state->asyncState) {
+            state->asyncState = std::make_shared<AsyncState>();
+            state->asyncState->event = this;
         }
+        return state->asyncState;
+    }
 
-        if (m_deletedHandlersCounter) {
-            for (size_t i = 0; i < handlers->size(); ++i) {
-                if ((*handlers)[i] == nullptr) {
-                    handlers->erase(handlers->begin() + i--);
-                    if (!--m_deletedHandlersCounter) {
-                        break;
-                    }
-                    continue;
-                }
-            }
+    // Points pending asynchronous emissions to the event, nullptr drops them
+    void setAsyncEvent(Event *event) {
+        State *state = this->currentState();
+        if (state && state->asyncState) {
+            std::unique_lock lock(state->asyncState->mutex);
+            state->asyncState->event = event;
         }
+    }
 
-        // Someone trying destroyed this event during execution
-        if (m_destroyed) {
-            // Delete event handlers
-            for (TDelegate *delegate : *handlers) {
-                delete delegate;
-            }
-            delete handlers;
-
-            lock.unlock();
-            delete mutex;
-
-            m_called = 0;
-
-            EventDispatcher::getInstance()->eventDestroyed(this);
-
+    // Emits the stored arguments unless the event was destroyed
+    static void emitDeferred(AsyncState &state, TArguments &args) {
+        std::unique_lock lock(state.mutex);
+        if (!state.event) {
             return;
         }
-        m_called = 0;
+        std::apply([&state] (auto &... values) {
+            static_cast<Event *>(state.event)->emitMove(std::forward<TArgs>(values)...);
+        }, args);
     }
 
-    // Copy assignment operator
-    Event& operator=(const Event &other) {
-        if (&other == this) {
-            return *this;
-        }
+    static TDelegate makeBatchDelegate(TBatchDelegate &&batchDelegate) {
+        TDelegate delegate;
+        delegate.template emplace<TBatchWrapper>(std::move(batchDelegate));
+        return delegate;
+    }
 
-        // Delete all handlers before copying
-        for (size_t i = 0; i < m_handlers->size(); ++i) {
-            delete (*m_handlers)[i];
+    // Calls a per-item handler with copies of the values of the batch item
+    template<class TItem>
+    static inline void invokeItem(TDelegate &delegate, const TItem &item) {
+        if constexpr (sizeof...(TArgs) == 1) {
+            delegate.invoke(TArgs(item)...);
+        } else {
+            std::apply([&delegate] (const auto &... values) {
+                delegate.invoke(TArgs(values)...);
+            }, item);
         }
-        m_handlers->clear();
+    }
 
-        // Copy handlers
-        for (size_t i = 0; i < other.m_handlers->size(); ++i) {
-            m_handlers->push_back( (*other.m_handlers)[i] );
+    // Calls the handlers, with moveToLast the last one consumes the arguments
+    template<bool moveToLast>
+    void emitHandlers(TArgs &... params) {
+        if constexpr (moveToLast) {
+            this->forEachHandler([&params...] (TDelegate &delegate, bool last) {
+                if (last) {
+                    delegate.invoke(std::forward<TArgs>(params)...);
+                } else {
+                    delegate.invoke(AbstractEvent::copyArgument<TArgs>(params)...);
+                }
+            });
+        } else {
+            this->forEachHandler([&params...] (TDelegate &delegate) {
+                delegate.invoke(AbstractEvent::copyArgument<TArgs>(params)...);
+            });
         }
-
-        return *this;
     }
+};
 
-protected:
+/**
+ * @brief Event whose handlers return results
+ * 
+ * Results are passed to a collector which decides the result of the 
+ * emission and may stop it as soon as the result is known, e.g. AnyOf stops 
+ * at the first handler returning true, see collectors.h:
+ * 
+ *     Event<bool(const Request &)> onAdmission;
+ *     bool rejected = onAdmission.emit(AnyOf(), request);
+ * 
+ * Handlers are attached and removed as with Event<TArgs...>, including 
+ * auto-removal of handlers of notifiable objects. They always run on the 
+ * emitting thread. The threading policy may be given as with 
+ * Event<TArgs...>, e.g. Event<SingleThreaded, bool(const Request &)>.
+ * 
+ * @tparam TReturn result of the handlers, a value type
+ * @tparam TArgs event arguments
+ */
+template<class TMutex, bool trackObjects, class TReturn, class... TArgs>
+class Event<ThreadingPolicy<TMutex, trackObjects>, TReturn(TArgs...)>
+    : public BasicEvent<TReturn(TArgs...), ThreadingPolicy<TMutex, trackObjects>> {
+    static_assert(!std::is_void_v<TReturn>, "Use Event<TArgs...> for handlers without results");
+    static_assert(!std::is_reference_v<TReturn>, "Handlers must return values");
+
+    using TBase = BasicEvent<TReturn(TArgs...), ThreadingPolicy<TMutex, trackObjects>>;
+    using TDelegate = Delegate<TReturn(TArgs...)>;
+public:
     /**************************************************************************
-     * Methods (Protected)
+     * Methods
      *************************************************************************/
 
-    inline int indexOfHandler(TDelegate *delegate) {
-        for (size_t i = 0; i < m_handlers->size(); ++i) {
-            if ( *((*m_handlers)[i]) != *delegate ) {
-                continue;
-            }
-            return i;
-        }
-        return -1;
-    }
-
-    inline void unsafeRemoveEventHandler(TDelegate *delegate) {
-        int index = indexOfHandler(delegate);
-        if (index == -1) {
-            return;
-        }
-        EventDispatcher::getInstance()->removeAttachment(this, (*m_handlers)[index]);
-        delete (*m_handlers)[index];
-        if (m_called) {
-            (*m_handlers)[index] = nullptr;
-            ++m_deletedHandlersCounter;
-            return;
-        }
-        m_handlers->erase(m_handlers->begin() + index);
+    /**
+     * @brief Emits the event passing the results to the collector
+     * 
+     * Handlers are called in order until the collector returns false from 
+     * collect(), arguments are passed as with Event<TArgs...>::operator().
+     * 
+     * @param collector object with bool collect(TReturn &&) and result() 
+     * methods, e.g. FirstResult, LastResult, AllResults, AnyOf or AllOf
+     * @return collector.result()
+     */
+    template<class TCollector>
+    auto emit(TCollector collector, TArgs... params) {
+        this->forEachHandler([&collector, &params...] (TDelegate &delegate) {
+            return collector.collect(delegate.invoke(AbstractEvent::copyArgument<TArgs>(params)...));
+        });
+        return collector.result();
     }
 
     /**************************************************************************
-     * Members
+     * Overloaded operators
      *************************************************************************/
 
-    std::vector<TDelegate *> *m_handlers = nullptr;
-    std::mutex *m_mutex = nullptr;
-    unsigned int m_deletedHandlersCounter = 0;
-    bool m_destroyed = false;
-    bool m_called = false;
+    // Emits the event, returns the result of the last handler if there is one
+    std::optional<TReturn> operator()(TArgs... params) {
+        std::optional<TReturn> result;
+        this->forEachHandler([&result, &params...] (TDelegate &delegate) {
+            result = delegate.invoke(AbstractEvent::copyArgument<TArgs>(params)...);
+        });
+        return result;
+    }
 };
 
+// Event with the default MultiThreaded policy
+template<class... TArgs>
+class Event : public Event<MultiThreaded, TArgs...> { };
+
+// Result collecting event with the default MultiThreaded policy
+template<class TReturn, class... TArgs>
+class Event<TReturn(TArgs...)> : public Event<MultiThreaded, TReturn(TArgs...)> { };
+
 } // namespace Hlk
 
 #endif // HLK_EVENT_H
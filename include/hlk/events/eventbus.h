@@ -0,0 +1,442 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin 
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under 
+ * the terms of the GNU Lesser General Public License as pubblished by the 
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT 
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more 
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License 
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+#ifndef HLK_EVENT_BUS_H
+#define HLK_EVENT_BUS_H
+
+#include "event.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Hlk {
+
+/**
+ * @brief Publish-subscribe bus of dot-separated topics with wildcard patterns
+ * 
+ * Handlers subscribe to a pattern of segments, e.g. "md.nyse.AAPL.trade", 
+ * where `*` matches exactly one segment and `#` any number of segments, 
+ * none included, so "md.*.AAPL.#" matches "md.nyse.AAPL" and 
+ * "md.nyse.AAPL.trade". Each pattern has its own Event<TArgs...> kept in a 
+ * trie of the segments, so handlers are attached with the arguments of 
+ * Event::addEventHandler() and handlers of notifiable objects are removed 
+ * when the objects are destroyed.
+ * 
+ * The first publication of a topic walks the trie and stores the events of 
+ * the matching patterns with the topic, later ones find the topic with one 
+ * hash lookup of the string without copying it. Topics interned by topic() 
+ * are kept for the life of the bus and published through a Topic handle 
+ * without the lookup. Topics published by name are kept in a cache of 
+ * limited size which is emptied when it is full, so topics built at 
+ * runtime, e.g. from order ids, don't grow the bus. Adding or erasing a 
+ * pattern invalidates the stored events, attaching handlers to an existing 
+ * pattern doesn't. The bus is locked only to find the events, handlers may 
+ * subscribe, unsubscribe and publish from an emission.
+ * 
+ * @tparam TArgs event arguments, passed to the events of all matching 
+ * patterns, so they must be copyable
+ */
+template<class... TArgs>
+class EventBus {
+    using TEvent = Event<TArgs...>;
+
+    // Events of the patterns matching a topic, shared with running publications
+    using TRoute = std::vector<std::shared_ptr<TEvent>>;
+
+    struct Node {
+        std::unordered_map<std::string, std::unique_ptr<Node>> children;
+        std::unique_ptr<Node> anySegment;
+        std::unique_ptr<Node> anySegments;
+        std::shared_ptr<TEvent> event;
+    };
+
+    struct Entry {
+        std::string name;
+        std::shared_ptr<const TRoute> route;
+        uint64_t generation = 0;
+
+        // Kept until the bus is destroyed, otherwise evicted with the cache
+        bool interned = false;
+    };
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    // Interned topic, valid as long as the bus
+    class Topic {
+        friend class EventBus;
+    public:
+        Topic() = default;
+
+        bool isValid() const { return m_entry != nullptr; }
+
+        // Name of the topic, the handle must be valid
+        const std::string &name() const { return m_entry->name; }
+
+        bool operator==(const Topic &other) const { return m_entry == other.m_entry; }
+        bool operator!=(const Topic &other) const { return m_entry != other.m_entry; }
+
+    protected:
+        explicit Topic(Entry *entry) 
+        : m_entry(entry) { }
+
+        Entry *m_entry = nullptr;
+    };
+
+    /**************************************************************************
+     * Constants
+     *************************************************************************/
+
+    static constexpr char separator = '.';
+    static constexpr std::string_view anySegment = "*";
+    static constexpr std::string_view anySegments = "#";
+
+    // Topics published by name whose events are cached, see EventBus()
+    static constexpr size_t defaultCacheCapacity = 4096;
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    // Topics published by name are cached up to the capacity, then the cache is emptied
+    explicit EventBus(size_t cacheCapacity = defaultCacheCapacity) 
+    : m_cacheCapacity(cacheCapacity) { }
+
+    EventBus(const EventBus &other) = delete;
+    EventBus(EventBus && other) = delete;
+    ~EventBus() = default;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    /**
+     * @brief Attaches a handler called by publications of matching topics
+     * 
+     * @param pattern topic or pattern with `*` and `#` segments
+     * @param handler arguments of Event::addEventHandler(), e.g. an object 
+     * and its method, a lambda and its priority
+     * @return connection of the handler, valid together with the pattern
+     */
+    template<class... THandler>
+    Connection addEventHandler(std::string_view pattern, THandler &&... handler) {
+        return eventOf(pattern)->addEventHandler(std::forward<THandler>(handler)...);
+    }
+
+    // Removes a handler of the pattern, the arguments are those of Event::removeEventHandler()
+    template<class... THandler>
+    void removeEventHandler(std::string_view pattern, THandler &&... handler) {
+        std::shared_ptr<TEvent> event;
+        {
+            std::unique_lock lock(m_mutex);
+            if (Node *node = findNode(pattern)) {
+                event = node->event;
+            }
+        }
+        if (event) {
+            event->removeEventHandler(std::forward<THandler>(handler)...);
+        }
+    }
+
+    // Removes the pattern with all its handlers and the trie nodes only it used
+    void erase(std::string_view pattern) {
+        std::unique_lock lock(m_mutex);
+        if (eraseBelow(&m_root, split(pattern), 0)) {
+            ++m_generation;
+        }
+    }
+
+    // Removes all patterns and handlers, interned topics stay valid
+    void clear() {
+        std::unique_lock lock(m_mutex);
+        m_root = Node();
+        ++m_generation;
+    }
+
+    // Interns the topic for the life of the bus, publishing through the handle skips the lookup
+    Topic topic(std::string_view name) {
+        std::unique_lock lock(m_mutex);
+        Entry *entry = entryOf(name);
+        if (!entry->interned) {
+            entry->interned = true;
+            --m_cached;
+        }
+        return Topic(entry);
+    }
+
+    // Calls the handlers of all patterns matching the topic
+    void publish(std::string_view topic, TArgs... args) {
+        std::shared_ptr<const TRoute> route;
+        {
+            std::unique_lock lock(m_mutex);
+            route = routeOf(entryOf(topic));
+        }
+        emit(*route, args...);
+    }
+
+    // Publishes an interned topic, see publish(std::string_view, TArgs...)
+    void publish(const Topic &topic, TArgs... args) {
+        std::shared_ptr<const TRoute> route;
+        {
+            std::unique_lock lock(m_mutex);
+            route = routeOf(topic.m_entry);
+        }
+        emit(*route, args...);
+    }
+
+    // True if no pattern is left, erasing patterns removes their trie nodes
+    bool empty() const {
+        std::unique_lock lock(m_mutex);
+        return isUnused(m_root);
+    }
+
+    // Number of topics published by name and cached, at most the capacity
+    size_t cachedTopics() const {
+        std::unique_lock lock(m_mutex);
+        return m_cached;
+    }
+
+    // True if the topic or pattern matches the pattern
+    static bool matches(std::string_view pattern, std::string_view topic) {
+        return matchSegments(split(pattern), 0, split(topic), 0);
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    EventBus& operator=(const EventBus &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Event of the pattern, created with its trie nodes on first use
+    std::shared_ptr<TEvent> eventOf(std::string_view pattern) {
+        std::unique_lock lock(m_mutex);
+        Node *node = &m_root;
+        for (std::string_view segment : split(pattern)) {
+            std::unique_ptr<Node> *child;
+            if (segment == anySegment) {
+                child = &node->anySegment;
+            } else if (segment == anySegments) {
+                child = &node->anySegments;
+            } else {
+                child = &node->children[std::string(segment)];
+            }
+            if (!*child) {
+                *child = std::make_unique<Node>();
+            }
+            node = child->get();
+        }
+        if (!node->event) {
+            node->event = std::make_shared<TEvent>();
+            ++m_generation;
+        }
+        return node->event;
+    }
+
+    // Trie node of the pattern, nullptr if it was never subscribed to
+    Node *findNode(std::string_view pattern) {
+        Node *node = &m_root;
+        for (std::string_view segment : split(pattern)) {
+            if (segment == anySegment) {
+                node = node->anySegment.get();
+            } else if (segment == anySegments) {
+                node = node->anySegments.get();
+            } else {
+                auto it = node->children.find(std::string(segment));
+                node = it == node->children.end() ? nullptr : it->second.get();
+            }
+            if (node == nullptr) {
+                return nullptr;
+            }
+        }
+        return node;
+    }
+
+    // Entry of the topic, the key views the name owned by the entry
+    Entry *entryOf(std::string_view name) {
+        auto it = m_topics.find(name);
+        if (it != m_topics.end()) {
+            return it->second.get();
+        }
+        if (m_cached >= m_cacheCapacity) {
+            evictCache();
+        }
+        ++m_cached;
+        auto entry = std::make_unique<Entry>();
+        entry->name = std::string(name);
+        Entry *result = entry.get();
+        m_topics.emplace(result->name, std::move(entry));
+        return result;
+    }
+
+    // Drops the topics which are not interned, Topic handles point only to interned ones
+    void evictCache() {
+        for (auto it = m_topics.begin(); it != m_topics.end();) {
+            it = it->second->interned ? std::next(it) : m_topics.erase(it);
+        }
+        m_cached = 0;
+    }
+
+    /* Resets the event of the pattern below the node and drops the nodes left 
+    without events and children. Returns true if the pattern had an event */
+    bool eraseBelow(Node *node, const std::vector<std::string_view> &segments, size_t index) {
+        if (index == segments.size()) {
+            return std::exchange(node->event, nullptr) != nullptr;
+        }
+        std::string_view segment = segments[index];
+        if (segment == anySegment || segment == anySegments) {
+            std::unique_ptr<Node> &child = segment == anySegment ? node->anySegment : node->anySegments;
+            if (!child) {
+                return false;
+            }
+            bool erased = eraseBelow(child.get(), segments, index + 1);
+            if (isUnused(*child)) {
+                child.reset();
+            }
+            return erased;
+        }
+        auto it = node->children.find(std::string(segment));
+        if (it == node->children.end()) {
+            return false;
+        }
+        bool erased = eraseBelow(it->second.get(), segments, index + 1);
+        if (isUnused(*it->second)) {
+            node->children.erase(it);
+        }
+        return erased;
+    }
+
+    // Events of the topic, resolved again if patterns changed since the last time
+    std::shared_ptr<const TRoute> routeOf(Entry *entry) {
+        if (entry->route && entry->generation == m_generation) {
+            return entry->route;
+        }
+        auto route = std::make_shared<TRoute>();
+        resolve(&m_root, split(entry->name), 0, *route);
+        entry->route = std::move(route);
+        entry->generation = m_generation;
+        return entry->route;
+    }
+
+    // Collects the events of the patterns below the node matching the segments from the index on
+    void resolve(Node *node, const std::vector<std::string_view> &segments, size_t index, TRoute &route) {
+        if (node->anySegments) {
+            for (size_t next = index; next <= segments.size(); ++next) {
+                resolve(node->anySegments.get(), segments, next, route);
+            }
+        }
+        if (index == segments.size()) {
+            // Patterns with several `#` may match in more than one way
+            if (node->event && std::find(route.begin(), route.end(), node->event) == route.end()) {
+                route.push_back(node->event);
+            }
+            return;
+        }
+        auto it = node->children.find(std::string(segments[index]));
+        if (it != node->children.end()) {
+            resolve(it->second.get(), segments, index + 1, route);
+        }
+        if (node->anySegment) {
+            resolve(node->anySegment.get(), segments, index + 1, route);
+        }
+    }
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    static bool isUnused(const Node &node) {
+        return !node.event && node.children.empty() && !node.anySegment && !node.anySegments;
+    }
+
+    static void emit(const TRoute &route, TArgs &... args) {
+        for (const std::shared_ptr<TEvent> &event : route) {
+            (*event)(args...);
+        }
+    }
+
+    static std::vector<std::string_view> split(std::string_view name) {
+        std::vector<std::string_view> segments;
+        size_t begin = 0;
+        for (;;) {
+            size_t end = name.find(separator, begin);
+            segments.push_back(name.substr(begin, end - begin));
+            if (end == std::string_view::npos) {
+                return segments;
+            }
+            begin = end + 1;
+        }
+    }
+
+    static bool matchSegments(const std::vector<std::string_view> &pattern, size_t patternIndex, 
+        const std::vector<std::string_view> &topic, size_t topicIndex) {
+        if (patternIndex == pattern.size()) {
+            return topicIndex == topic.size();
+        }
+        if (pattern[patternIndex] == anySegments) {
+            for (size_t next = topicIndex; next <= topic.size(); ++next) {
+                if (matchSegments(pattern, patternIndex + 1, topic, next)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (topicIndex == topic.size()) {
+            return false;
+        }
+        if (pattern[patternIndex] != anySegment && pattern[patternIndex] != topic[topicIndex]) {
+            return false;
+        }
+        return matchSegments(pattern, patternIndex + 1, topic, topicIndex + 1);
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    mutable std::mutex m_mutex;
+    Node m_root;
+
+    // Incremented whenever a pattern is added or erased, see routeOf()
+    uint64_t m_generation = 0;
+    std::unordered_map<std::string_view, std::unique_ptr<Entry>> m_topics;
+
+    // Topics in m_topics which are not interned
+    size_t m_cached = 0;
+    size_t m_cacheCapacity;
+};
+
+} // namespace Hlk
+
+#endif // HLK_EVENT_BUS_H
@@ -23,68 +23,122 @@
 #include "eventdispatcher.h"
 #include "notifiableobject.h"
 #include "abstractevent.h"
+#include "instrumentation.h"
+
+#include <thread>
 
 namespace Hlk {
 
-std::mutex EventDispatcher::m_mutex;
-EventDispatcher *EventDispatcher::m_instance = nullptr;
+HLK_EVENTS_INLINE Attachment *EventDispatcher::registerAttachment(AbstractEvent *event, NotifiableObject *notifiable, const Connection &connection) {
+    auto attachment = new Attachment();
+    attachment->event = event;
+    attachment->notifiable = notifiable;
+    attachment->connection = connection;
+
+    Attachment *&head = event->attachments();
+    attachment->eventNext = head;
+    if (head) {
+        head->eventPrev = attachment;
+    }
+    head = attachment;
 
-EventDispatcher *EventDispatcher::getInstance() {
-    std::unique_lock lock(m_mutex);
-    if (!m_instance) {
-        m_instance = new EventDispatcher();
+    std::unique_lock lock(notifiable->m_attachmentsMutex, std::defer_lock);
+    Instrumentation::acquireAttachments(lock);
+    attachment->notifiableNext = notifiable->m_attachments;
+    if (notifiable->m_attachments) {
+        notifiable->m_attachments->notifiablePrev = attachment;
     }
-    return m_instance;
+    notifiable->m_attachments = attachment;
+    Instrumentation::attachmentAdded(event, notifiable);
+
+    return attachment;
 }
 
-void EventDispatcher::registerAttachment(AbstractEvent *event, NotifiableObject *notifiable, AbstractDelegate *delegate) {
-    std::unique_lock lock(m_vectorMutex);
-    
-    m_events.push_back(event);
-    m_notifiables.push_back(notifiable);
-    m_delegates.push_back(delegate);
+HLK_EVENTS_INLINE void EventDispatcher::removeAttachment(Attachment *attachment) {
+    unlinkFromEvent(attachment);
+
+    std::unique_lock lock(attachment->notifiable->m_attachmentsMutex, std::defer_lock);
+    Instrumentation::acquireAttachments(lock);
+    unlinkFromNotifiable(attachment);
+    lock.unlock();
+
+    Instrumentation::attachmentRemoved(attachment->event, attachment->notifiable);
+    delete attachment;
 }
 
-void EventDispatcher::removeAttachment(AbstractEvent *event, AbstractDelegate *delegate) {
-    std::unique_lock lock(m_vectorMutex);
+HLK_EVENTS_INLINE void EventDispatcher::eventMoved(AbstractEvent *event) {
+    for (Attachment *attachment = event->attachments(); attachment; attachment = attachment->eventNext) {
+        std::unique_lock lock(attachment->notifiable->m_attachmentsMutex);
+        attachment->event = event;
+    }
+}
 
-    for (size_t i = 0; i < m_events.size(); ++i) {
-        if (m_events[i] != event || delegate != m_delegates[i]) {
-            continue;
-        }
-        m_events.erase(m_events.begin() + i);
-        m_notifiables.erase(m_notifiables.begin() + i);
-        m_delegates.erase(m_delegates.begin() + i);
-        return;
+HLK_EVENTS_INLINE void EventDispatcher::removeAttachments(AbstractEvent *event) {
+    while (Attachment *attachment = event->attachments()) {
+        unlinkFromEvent(attachment);
+
+        std::unique_lock lock(attachment->notifiable->m_attachmentsMutex, std::defer_lock);
+        Instrumentation::acquireAttachments(lock);
+        unlinkFromNotifiable(attachment);
+        lock.unlock();
+
+        Instrumentation::attachmentRemoved(event, attachment->notifiable);
+        delete attachment;
     }
 }
 
-void EventDispatcher::eventDestroyed(AbstractEvent *event) {
-    std::unique_lock lock(m_vectorMutex);
+HLK_EVENTS_INLINE void EventDispatcher::eventDestroyed(AbstractEvent *event) {
+    removeAttachments(event);
+}
+
+HLK_EVENTS_INLINE void EventDispatcher::notifiableDestroyed(NotifiableObject *notifiable) {
+    Stopwatch stopwatch(Tracer::isRecording());
+    std::unique_lock lock(notifiable->m_attachmentsMutex, std::defer_lock);
+    Instrumentation::acquireAttachments(lock);
 
-    for (size_t i = 0; i < m_events.size(); ++i) {
-        if (m_events[i] != event) {
+    while (Attachment *attachment = notifiable->m_attachments) {
+        /* The event can't be destroyed while the attachment is linked, but it 
+        may be waiting for this notifiable in the opposite lock order */
+        AbstractEvent *event = attachment->event;
+        if (!event->tryLockHandlers()) {
+            lock.unlock();
+            Instrumentation::attachmentBackoff();
+            std::this_thread::yield();
+            Instrumentation::acquireAttachments(lock);
             continue;
         }
-        m_events.erase(m_events.begin() + i);
-        m_notifiables.erase(m_notifiables.begin() + i);
-        m_delegates.erase(m_delegates.begin() + i);
-        --i;
+
+        unlinkFromNotifiable(attachment);
+        unlinkFromEvent(attachment);
+        event->unsafeRemoveEventHandler(attachment->connection);
+        Instrumentation::attachmentRemoved(event, notifiable);
+        event->unlockHandlers();
+        delete attachment;
     }
+    lock.unlock();
+
+    Instrumentation::notifiableDestroyed(notifiable, stopwatch);
 }
 
-void EventDispatcher::notifiableDestroyed(NotifiableObject *notifiable) {
-    std::unique_lock lock(m_vectorMutex);
+HLK_EVENTS_INLINE void EventDispatcher::unlinkFromEvent(Attachment *attachment) {
+    if (attachment->eventPrev) {
+        attachment->eventPrev->eventNext = attachment->eventNext;
+    } else {
+        attachment->event->attachments() = attachment->eventNext;
+    }
+    if (attachment->eventNext) {
+        attachment->eventNext->eventPrev = attachment->eventPrev;
+    }
+}
 
-    for (size_t i = 0; i < m_notifiables.size(); ++i) {
-        if (m_notifiables[i] != notifiable) {
-            continue;
-        }
-        m_events[i]->removeEventHandler(m_delegates[i]);
-        m_events.erase(m_events.begin() + i);
-        m_notifiables.erase(m_notifiables.begin() + i);
-        m_delegates.erase(m_delegates.begin() + i);
-        --i;
+HLK_EVENTS_INLINE void EventDispatcher::unlinkFromNotifiable(Attachment *attachment) {
+    if (attachment->notifiablePrev) {
+        attachment->notifiablePrev->notifiableNext = attachment->notifiableNext;
+    } else {
+        attachment->notifiable->m_attachments = attachment->notifiableNext;
+    }
+    if (attachment->notifiableNext) {
+        attachment->notifiableNext->notifiablePrev = attachment->notifiablePrev;
     }
 }
 
@@ -23,48 +23,66 @@
 #ifndef HLK_EVENT_DISPATCHER_H
 #define HLK_EVENT_DISPATCHER_H
 
+#include "config.h"
+
 #include <mutex>
-#include <vector>
 
 namespace Hlk {
 
 class AbstractEvent;
+class Connection;
 class NotifiableObject;
-class AbstractDelegate;
+struct Attachment;
 
+/**
+ * @brief Tracks handlers which belong to notifiable objects
+ * 
+ * Attachments are stored in intrusive lists owned by the event and by the 
+ * notifiable object, there is no global registry. Methods taking an event or 
+ * an attachment expect the handlers of the event to be locked by the 
+ * caller. Locks are taken in the event -> notifiable order, 
+ * notifiableDestroyed() goes the opposite way and backs off if the event is 
+ * busy.
+ */
 class EventDispatcher {
 public:
     /**************************************************************************
      * Methods 
      *************************************************************************/
 
-    static EventDispatcher *getInstance();
+    /* The dispatcher has no state, so the instance is constant-initialized 
+    and getting it is a plain address load without locking */
+    static EventDispatcher *getInstance() {
+        static EventDispatcher instance;
+        return &instance;
+    }
+
+    Attachment *registerAttachment(AbstractEvent *event, NotifiableObject *notifiable, const Connection &connection);
+    void removeAttachment(Attachment *attachment);
 
-    void registerAttachment(AbstractEvent *event, NotifiableObject *notifiable, AbstractDelegate *delegate);
-    void removeAttachment(AbstractEvent *event, AbstractDelegate *delegate);
+    // Removes every attachment of the event, O(n)
+    void removeAttachments(AbstractEvent *event);
+
+    // Points the attachments of a moved event, which it took along, to it
+    void eventMoved(AbstractEvent *event);
 
     void eventDestroyed(AbstractEvent *event);
     void notifiableDestroyed(NotifiableObject *notifiable);
 
 protected:
     /**************************************************************************
-     * Members
+     * Methods (Protected)
      *************************************************************************/
 
-    static std::mutex m_mutex;
-    static EventDispatcher *m_instance;
-
-    std::mutex m_vectorMutex;
-    std::vector<AbstractEvent *> m_events;
-    std::vector<NotifiableObject *> m_notifiables;
-    std::vector<AbstractDelegate *> m_delegates;
+    static void unlinkFromEvent(Attachment *attachment);
+    static void unlinkFromNotifiable(Attachment *attachment);
 
 private:
     /**************************************************************************
      * Constructors / Destructors (Private)
      *************************************************************************/
 
-    EventDispatcher() = default;    
+    constexpr EventDispatcher() = default;
 };
 
 } // Hlk
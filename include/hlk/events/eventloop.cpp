@@ -0,0 +1,139 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#include "eventloop.h"
+
+namespace Hlk {
+
+HLK_EVENTS_INLINE thread_local EventLoop *EventLoop::m_current = nullptr;
+
+HLK_EVENTS_INLINE EventLoop::~EventLoop() {
+    quit();
+    wait();
+    while (Message *message = pop()) {
+        delete message;
+    }
+}
+
+HLK_EVENTS_INLINE void EventLoop::start() {
+    m_thread = std::thread([this] () { run(); });
+}
+
+HLK_EVENTS_INLINE void EventLoop::run() {
+    while (!m_quit.load(std::memory_order_acquire)) {
+        if (processEvents() == 0) {
+            waitForMessages();
+        }
+    }
+    m_quit.store(false, std::memory_order_relaxed);
+}
+
+HLK_EVENTS_INLINE void EventLoop::quit() {
+    m_quit.store(true, std::memory_order_seq_cst);
+    std::unique_lock lock(m_sleepMutex);
+    m_wakeup.notify_one();
+}
+
+HLK_EVENTS_INLINE void EventLoop::wait() {
+    if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+        m_thread.join();
+    }
+}
+
+HLK_EVENTS_INLINE size_t EventLoop::processEvents(size_t maxEvents) {
+    EventLoop *previous = m_current;
+    m_current = this;
+
+    size_t processed = 0;
+    while (processed < maxEvents) {
+        Message *message = pop();
+        if (message == nullptr) {
+            break;
+        }
+        message->run();
+        delete message;
+        ++processed;
+    }
+
+    m_current = previous;
+    return processed;
+}
+
+HLK_EVENTS_INLINE void EventLoop::push(Message *message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message *previous = m_head.exchange(message, std::memory_order_seq_cst);
+    previous->next.store(message, std::memory_order_release);
+
+    // Pairs with waitForMessages(), either it sees the message or we see it sleeping
+    if (m_sleeping.load(std::memory_order_seq_cst)) {
+        std::unique_lock lock(m_sleepMutex);
+        m_wakeup.notify_one();
+    }
+}
+
+HLK_EVENTS_INLINE EventLoop::Message *EventLoop::pop() {
+    Message *tail = m_tail;
+    Message *next = tail->next.load(std::memory_order_acquire);
+
+    // The stub is skipped, it only keeps the list non-empty
+    if (tail == &m_stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    // The tail is the last message, unless a producer is linking a new one
+    if (tail != m_head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+HLK_EVENTS_INLINE bool EventLoop::hasMessages() const {
+    return m_tail != &m_stub || m_head.load(std::memory_order_seq_cst) != &m_stub;
+}
+
+HLK_EVENTS_INLINE void EventLoop::waitForMessages() {
+    std::unique_lock lock(m_sleepMutex);
+    m_sleeping.store(true, std::memory_order_seq_cst);
+    m_wakeup.wait(lock, [this] () {
+        return hasMessages() || m_quit.load(std::memory_order_seq_cst);
+    });
+    m_sleeping.store(false, std::memory_order_relaxed);
+}
+
+} // namespace Hlk
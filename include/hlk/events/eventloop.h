@@ -0,0 +1,180 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_EVENT_LOOP_H
+#define HLK_EVENT_LOOP_H
+
+#include "abstractexecutor.h"
+#include "config.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Hlk {
+
+/**
+ * @brief Thread owning a mailbox of calls
+ * 
+ * Handlers of notifiable objects bound to a loop with 
+ * NotifiableObject::setEventLoop() run on the loop thread: an emission from 
+ * that thread calls them directly, emissions from other threads post the 
+ * calls to the mailbox, which is processed in FIFO order. The mailbox is a 
+ * lock-free intrusive queue, the loop thread sleeps only when it is empty. 
+ * The loop must outlive the objects bound to it.
+ */
+class EventLoop : public AbstractExecutor {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    EventLoop() = default;
+
+    EventLoop(const EventLoop &other) = delete;
+
+    // Stops the thread started by start(), pending calls are dropped
+    ~EventLoop();
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    // Loop running on the calling thread, nullptr if there is none
+    static EventLoop *current() { return m_current; }
+
+    // True on the thread running or processing the loop
+    bool isInLoopThread() const { return m_current == this; }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Runs the loop on a new thread owned by the loop
+    void start();
+
+    // Runs the loop on the calling thread until quit() is called
+    void run();
+
+    /**
+     * @brief Makes run() return, may be called from any thread
+     * 
+     * Calls already posted are processed by the next run(). If the loop is 
+     * not running, the next run() returns immediately.
+     */
+    void quit();
+
+    // Waits for the thread started by start() to finish
+    void wait();
+
+    /**
+     * @brief Processes the posted calls on the calling thread
+     * 
+     * For loops driven by another event loop instead of run(). Must not be 
+     * called concurrently with run() or itself.
+     * 
+     * @return number of processed calls
+     */
+    size_t processEvents(size_t maxEvents = std::numeric_limits<size_t>::max());
+
+    // Posts the callable to the loop, may be called from any thread
+    template<class TTask>
+    void post(TTask &&task) {
+        push(new TaskMessage<std::decay_t<TTask>>(std::forward<TTask>(task)));
+    }
+
+    virtual void execute(Task &&task) override {
+        post(std::move(task));
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    EventLoop& operator=(const EventLoop &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    struct Message {
+        std::atomic<Message *> next { nullptr };
+
+        virtual ~Message() = default;
+        virtual void run() { }
+    };
+
+    template<class TTask>
+    struct TaskMessage : public Message {
+        template<class T>
+        explicit TaskMessage(T &&task) : task(std::forward<T>(task)) { }
+
+        virtual void run() override { task(); }
+
+        TTask task;
+    };
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    void push(Message *message);
+
+    // Takes the oldest message, nullptr if there is none or it is being pushed
+    Message *pop();
+
+    // Consumer side check, true while a message is pushed or pending
+    bool hasMessages() const;
+
+    void waitForMessages();
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    static thread_local EventLoop *m_current;
+
+    // Producers exchange the head, the loop thread takes messages at the tail
+    alignas(64) std::atomic<Message *> m_head { &m_stub };
+    alignas(64) Message *m_tail = &m_stub;
+    Message m_stub;
+
+    std::atomic<bool> m_quit { false };
+    std::atomic<bool> m_sleeping { false };
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+    std::thread m_thread;
+};
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "eventloop.cpp"
+#endif
+
+#endif // HLK_EVENT_LOOP_H
@@ -0,0 +1,171 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#include "eventqueue.h"
+
+#include <thread>
+
+namespace Hlk {
+
+HLK_EVENTS_INLINE EventQueue::EventQueue(size_t capacity, OverflowPolicy policy, size_t slotSize)
+    : m_policy(policy) {
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    m_mask = rounded - 1;
+
+    // Every slot must hold at least a pointer to a boxed emission
+    constexpr size_t alignment = alignof(std::max_align_t);
+    m_slotSize = slotSize < sizeof(void *) ? sizeof(void *) : slotSize;
+    m_slotSize = (m_slotSize + alignment - 1) / alignment * alignment;
+
+    m_cells.reset(new Cell[rounded]);
+    for (size_t i = 0; i < rounded; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_storage.reset(new unsigned char[rounded * m_slotSize]);
+}
+
+HLK_EVENTS_INLINE EventQueue::~EventQueue() {
+    size_t position;
+    while (Cell *cell = claimForRead(position)) {
+        cell->destroy(storageOf(position));
+        release(*cell, position);
+    }
+}
+
+HLK_EVENTS_INLINE size_t EventQueue::size() const {
+    size_t read = m_readPosition.load(std::memory_order_acquire);
+    size_t write = m_writePosition.load(std::memory_order_acquire);
+    return write > read ? write - read : 0;
+}
+
+HLK_EVENTS_INLINE void EventQueue::resetCounters() {
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_overwritten.store(0, std::memory_order_relaxed);
+    m_highWater.store(size(), std::memory_order_relaxed);
+}
+
+HLK_EVENTS_INLINE void EventQueue::execute(Task &&task) {
+    push(std::move(task));
+}
+
+HLK_EVENTS_INLINE size_t EventQueue::processEvents(size_t maxEvents) {
+    size_t processed = 0;
+    size_t position;
+    while (processed < maxEvents) {
+        Cell *cell = claimForRead(position);
+        if (cell == nullptr) {
+            break;
+        }
+        void *storage = storageOf(position);
+        cell->invoke(storage);
+        cell->destroy(storage);
+        release(*cell, position);
+        ++processed;
+    }
+    return processed;
+}
+
+HLK_EVENTS_INLINE EventQueue::Cell *EventQueue::claimForWrite(size_t &position) {
+    position = m_writePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell *cell = &m_cells[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+        if (difference == 0) {
+            if (m_writePosition.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed)) {
+                return cell;
+            }
+        } else if (difference < 0) {
+            return nullptr;
+        } else {
+            position = m_writePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+HLK_EVENTS_INLINE EventQueue::Cell *EventQueue::claimForRead(size_t &position) {
+    // Producers dropping the oldest emission compete with the consumer here
+    position = m_readPosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell *cell = &m_cells[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+        if (difference == 0) {
+            if (m_readPosition.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed)) {
+                return cell;
+            }
+        } else if (difference < 0) {
+            return nullptr;
+        } else {
+            position = m_readPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+HLK_EVENTS_INLINE void EventQueue::release(Cell &cell, size_t position) {
+    cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+}
+
+HLK_EVENTS_INLINE bool EventQueue::handleOverflow() {
+    switch (m_policy) {
+    case OverflowPolicy::DropNewest:
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    case OverflowPolicy::DropOldest:
+    case OverflowPolicy::Overwrite: {
+        size_t position;
+        Cell *cell = claimForRead(position);
+        if (cell == nullptr) {
+            // The oldest slot is being written or processed right now
+            std::this_thread::yield();
+            return true;
+        }
+        cell->destroy(storageOf(position));
+        release(*cell, position);
+        auto &counter = m_policy == OverflowPolicy::Overwrite ? m_overwritten : m_dropped;
+        counter.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    case OverflowPolicy::Block:
+    default:
+        std::this_thread::yield();
+        return true;
+    }
+}
+
+HLK_EVENTS_INLINE void EventQueue::updateHighWater(size_t writePosition) {
+    size_t read = m_readPosition.load(std::memory_order_relaxed);
+    if (read >= writePosition) {
+        return;
+    }
+    size_t pending = writePosition - read;
+    size_t highWater = m_highWater.load(std::memory_order_relaxed);
+    while (pending > highWater && !m_highWater.compare_exchange_weak(highWater, pending,
+        std::memory_order_relaxed)) { }
+}
+
+} // namespace Hlk
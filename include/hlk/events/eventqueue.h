@@ -0,0 +1,241 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_EVENT_QUEUE_H
+#define HLK_EVENT_QUEUE_H
+
+#include "abstractexecutor.h"
+#include "config.h"
+#include "event.h"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Hlk {
+
+/**
+ * @brief Bounded queue of deferred emissions
+ * 
+ * Any number of threads post emissions of any events, a single consumer 
+ * thread calls their handlers in processEvents(). The queue is a lock-free 
+ * ring of fixed-size slots, the arguments are stored in the slot, so posting 
+ * doesn't allocate unless an emission is larger than the slot. Emissions of 
+ * events destroyed before processing are dropped. The queue is also an 
+ * executor, so Event::emitAsync() can be deferred to it with 
+ * Event::setExecutor().
+ */
+class EventQueue : public AbstractExecutor {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    // What post() does when the queue is full
+    enum class OverflowPolicy {
+        Block,      // Wait until the consumer frees a slot
+        DropNewest, // Drop the posted emission, post() returns false
+        DropOldest, // Drop the oldest pending emission to make room
+        Overwrite   // As DropOldest, counted in overwrittenCount() instead
+    };
+
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    /**
+     * @param capacity maximum number of pending emissions, rounded up to a 
+     * power of two
+     * @param policy behaviour of post() on a full queue
+     * @param slotSize bytes of inline storage per emission, larger emissions 
+     * are stored on the heap
+     */
+    explicit EventQueue(size_t capacity = 1024, OverflowPolicy policy = OverflowPolicy::Block,
+        size_t slotSize = 64);
+
+    EventQueue(const EventQueue &other) = delete;
+
+    // Drops pending emissions without calling their handlers
+    ~EventQueue();
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // Number of pending emissions, approximate while producers are active
+    size_t size() const;
+
+    OverflowPolicy overflowPolicy() const { return m_policy; }
+
+    // Emissions discarded by DropNewest and DropOldest policies
+    size_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Emissions discarded by Overwrite policy
+    size_t overwrittenCount() const { return m_overwritten.load(std::memory_order_relaxed); }
+
+    // Largest number of pending emissions observed by post()
+    size_t highWaterMark() const { return m_highWater.load(std::memory_order_relaxed); }
+
+    void resetCounters();
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    /**
+     * @brief Posts an emission of the event
+     * 
+     * Arguments are stored in the queue as with Event::emitAsync(), 
+     * move-only arguments are supported.
+     * 
+     * @return false if the emission was dropped by DropNewest policy
+     */
+    template<class... TArgs, class... TParams>
+    bool post(Event<TArgs...> &event, TParams &&... params) {
+        std::shared_ptr<typename Event<TArgs...>::AsyncState> state;
+        {
+            std::unique_lock lock(event.state()->mutex);
+            state = event.unsafeAsyncState();
+        }
+        using TArguments = typename Event<TArgs...>::TArguments;
+        return push([state, args = TArguments(std::forward<TParams>(params)...)] () mutable {
+            Event<TArgs...>::emitDeferred(*state, args);
+        });
+    }
+
+    // Posts the task, see post()
+    virtual void execute(Task &&task) override;
+
+    /**
+     * @brief Calls the handlers of pending emissions in the posting order
+     * 
+     * Must be called by one thread at a time. Handlers may post to the queue, 
+     * with Block policy a handler posting to a full queue never returns.
+     * 
+     * @param maxEvents maximum number of emissions to process
+     * @return number of processed emissions
+     */
+    size_t processEvents(size_t maxEvents = std::numeric_limits<size_t>::max());
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    EventQueue& operator=(const EventQueue &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    // Slot of the ring, free for the producer of position p if sequence == p
+    struct Cell {
+        std::atomic<size_t> sequence;
+        void (*invoke)(void *storage) = nullptr;
+        void (*destroy)(void *storage) = nullptr;
+    };
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    template<class TEntry>
+    bool push(TEntry &&entry) {
+        for (;;) {
+            size_t position;
+            if (Cell *cell = claimForWrite(position)) {
+                construct(*cell, storageOf(position), std::forward<TEntry>(entry));
+                cell->sequence.store(position + 1, std::memory_order_release);
+                updateHighWater(position + 1);
+                return true;
+            }
+            if (!handleOverflow()) {
+                return false;
+            }
+        }
+    }
+
+    template<class TEntry>
+    void construct(Cell &cell, void *storage, TEntry &&entry) {
+        using T = std::decay_t<TEntry>;
+        if (sizeof(T) <= m_slotSize && alignof(T) <= alignof(std::max_align_t)) {
+            new (storage) T(std::forward<TEntry>(entry));
+            cell.invoke = [] (void *storage) { (*static_cast<T *>(storage))(); };
+            cell.destroy = [] (void *storage) { static_cast<T *>(storage)->~T(); };
+        } else {
+            new (storage) T *(new T(std::forward<TEntry>(entry)));
+            cell.invoke = [] (void *storage) { (**static_cast<T **>(storage))(); };
+            cell.destroy = [] (void *storage) { delete *static_cast<T **>(storage); };
+        }
+    }
+
+    // Claims the cell at the write position, nullptr if the queue is full
+    Cell *claimForWrite(size_t &position);
+
+    // Claims the cell at the read position, nullptr if the queue is empty
+    Cell *claimForRead(size_t &position);
+
+    // Returns the cell claimed by claimForRead() to the producers
+    void release(Cell &cell, size_t position);
+
+    // Applies the policy to a full queue, false if the emission is dropped
+    bool handleOverflow();
+
+    void updateHighWater(size_t writePosition);
+
+    inline void *storageOf(size_t position) {
+        return m_storage.get() + (position & m_mask) * m_slotSize;
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    OverflowPolicy m_policy;
+    size_t m_mask;
+    size_t m_slotSize;
+    std::unique_ptr<Cell[]> m_cells;
+    std::unique_ptr<unsigned char[]> m_storage;
+
+    // Producers and the consumer touch different cache lines
+    alignas(64) std::atomic<size_t> m_writePosition { 0 };
+    alignas(64) std::atomic<size_t> m_readPosition { 0 };
+
+    alignas(64) std::atomic<size_t> m_dropped { 0 };
+    std::atomic<size_t> m_overwritten { 0 };
+    std::atomic<size_t> m_highWater { 0 };
+};
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "eventqueue.cpp"
+#endif
+
+#endif // HLK_EVENT_QUEUE_H
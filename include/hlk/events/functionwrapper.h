@@ -47,11 +47,13 @@ public:
 
     // Copy constructor
     FunctionWrapper(const FunctionWrapper &other) 
-    : m_func(other.m_func) { }
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_func(other.m_func) { }
 
     // Move constructor
-    FunctionWrapper(FunctionWrapper&& other) 
-    : m_func(other.m_func) {
+    FunctionWrapper(FunctionWrapper&& other) noexcept
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_func(other.m_func) {
         other.m_func = nullptr;
     }
 
@@ -61,20 +63,30 @@ public:
      * Methods
      *************************************************************************/
 
-    virtual TFWrapper* clone() override { 
-        return new TFWrapper(*this); 
+    virtual AbstractWrapper<TReturn(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TFWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<TReturn(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TFWrapper>(storage, *this);
+    }
+
+    virtual void destroy() override {
+        this->template dispose<TFWrapper>(this);
     }
 
     void bind(TReturn (*func)(TArgs...)) {
         m_func = func;
+        this->m_tag = this->template typeTag<TFWrapper>();
+        this->m_hash = this->hashBytes(&m_func, sizeof(m_func), reinterpret_cast<std::size_t>(this->m_tag));
     }
 
     /**************************************************************************
      * Overloaded operators
      *************************************************************************/
 
-    virtual TReturn operator()(TArgs... args) override {
-        return (*m_func)(args...);
+    virtual TReturn operator()(TArgs&&... args) override {
+        return (*m_func)(std::forward<TArgs>(args)...);
     }
 
     // Copy assignment operator
@@ -82,6 +94,7 @@ public:
         if (this == &other) {
             return *this;
         }
+        AbstractWrapper<TReturn(TArgs...)>::operator=(other);
         m_func = other.m_func;
         return *this;
     }
@@ -91,6 +104,7 @@ public:
         if (this == &other) {
             return *this;
         }
+        AbstractWrapper<TReturn(TArgs...)>::operator=(other);
         m_func = other.m_func;
         other.m_func = nullptr;
         return *this;
@@ -102,8 +116,7 @@ protected:
      *************************************************************************/
 
     virtual bool isEquals(const AbstractWrapper<TReturn(TArgs...)> &other) const override {
-        const TFWrapper *otherPtr = dynamic_cast<const TFWrapper *>(&other);
-        return otherPtr != nullptr && m_func == otherPtr->m_func;
+        return m_func == static_cast<const TFWrapper &>(other).m_func;
     }
 
     /**************************************************************************
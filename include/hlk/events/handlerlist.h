@@ -0,0 +1,439 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_HANDLER_LIST_H
+#define HLK_HANDLER_LIST_H
+
+#include "attachment.h"
+#include "connection.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Hlk {
+
+/**
+ * @brief Slot map of event handlers preserving the call order
+ * 
+ * Delegates live in slots with stable addresses. The call order is a separate 
+ * vector of slot indices, removing a handler only marks its position, which is 
+ * compacted later, so removal by Connection is O(1). The order is sorted by 
+ * descending priority, handlers of equal priority keep the order they were 
+ * appended in. Every handler is pushed to the end of the order, one with a 
+ * higher priority than the last marks the order unsorted and the next 
+ * emission merges the handlers appended since into place, so attaching k 
+ * handlers costs O(k log k + n) once instead of O(n) each, and positions of 
+ * running emissions never shift. Handlers removed while 
+ * an emission is in progress are destroyed when the outermost emission ends, 
+ * so a handler may safely remove itself. Once the list grows past 
+ * indexThreshold handlers a hash index of the delegates is built, so find() 
+ * and therefore duplicate detection on subscribe stay O(1). Not thread-safe, 
+ * the owning event serializes access.
+ * 
+ * @tparam TDelegate stored delegate type
+ */
+template<class TDelegate>
+class HandlerList {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    HandlerList() = default;
+    HandlerList(const HandlerList &other) = delete;
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    // Number of attached handlers
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // Number of positions in the call order including removed ones
+    size_t positions() const { return m_order.size(); }
+
+    // Delegate at the call order position, nullptr if removed
+    TDelegate *at(size_t position) {
+        uint32_t index = m_order[position];
+        return index == removedPosition ? nullptr : &m_slots[index].delegate;
+    }
+
+    // True if some handler is removed when called, see isOnce()
+    bool hasOnce() const { return m_onceHandlers != 0; }
+
+    // True if the handler at the call order position is removed when called
+    bool isOnce(size_t position) const {
+        return m_slots[m_order[position]].once;
+    }
+
+    // True if some handler may expire, see isWeak()
+    bool hasWeak() const { return m_weakHandlers != 0; }
+
+    // True if the delegate at the call order position may expire and has to be checked before the call
+    bool isWeak(size_t position) const {
+        return m_slots[m_order[position]].weak;
+    }
+
+    int priorityAt(size_t position) const { return m_priorities[position]; }
+
+    // True if no handler follows the position in the call order before end
+    bool isLast(size_t position, size_t end) const {
+        for (size_t i = end; i-- > position + 1;) {
+            if (m_order[i] != removedPosition) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Connection connectionAt(size_t position) const {
+        uint32_t index = m_order[position];
+        if (index == removedPosition) {
+            return Connection();
+        }
+        return Connection(index, m_slots[index].generation);
+    }
+
+    // Delegate of the connection, nullptr if it was removed
+    TDelegate *get(const Connection &connection) {
+        Slot *slot = slotOf(connection);
+        return slot ? &slot->delegate : nullptr;
+    }
+
+    // Attachment registered for the connection
+    Attachment *attachment(const Connection &connection) {
+        Slot *slot = slotOf(connection);
+        return slot ? slot->attachment : nullptr;
+    }
+
+    void setAttachment(const Connection &connection, Attachment *attachment) {
+        if (Slot *slot = slotOf(connection)) {
+            slot->attachment = attachment;
+        }
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    /**
+     * @brief Inserts the delegate after the handlers of the same or higher 
+     * priority
+     * 
+     * @param delegate attached delegate
+     * @param priority handlers with higher priority are called first
+     * @param once the handler is removed by the emission calling it
+     * @param weak the delegate may expire, see Delegate::expired()
+     * @return connection of the handler
+     */
+    Connection append(TDelegate &&delegate, int priority = 0, bool once = false, bool weak = false) {
+        uint32_t index;
+        if (m_freeSlots.empty()) {
+            index = m_slots.size();
+            m_slots.emplace_back();
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        Slot &slot = m_slots[index];
+        slot.delegate = std::move(delegate);
+        slot.attachment = nullptr;
+        slot.priority = priority;
+        slot.once = once;
+        slot.weak = weak;
+        slot.used = true;
+        insert(index, priority);
+        m_onceHandlers += once;
+        m_weakHandlers += weak;
+        ++m_size;
+
+        if (m_indexed) {
+            m_index.emplace(std::hash<TDelegate>()(slot.delegate), index);
+        } else if (m_size > indexThreshold) {
+            buildIndex();
+        }
+
+        return Connection(index, slot.generation);
+    }
+
+    // Removes the handler, returns false if the connection is stale
+    bool remove(const Connection &connection) {
+        Slot *slot = slotOf(connection);
+        if (!slot) {
+            return false;
+        }
+
+        m_order[slot->position] = removedPosition;
+        ++m_removedPositions;
+        m_onceHandlers -= slot->once;
+        m_weakHandlers -= slot->weak;
+        --m_size;
+
+        if (m_indexed) {
+            unindex(connection.index());
+        }
+
+        // Invalidate connections to the slot
+        slot->used = false;
+        if (++slot->generation == 0) {
+            slot->generation = 1;
+        }
+
+        if (m_emissions) {
+            m_retiredSlots.push_back(connection.index());
+            return true;
+        }
+        release(connection.index());
+        if (m_removedPositions > m_order.size() / 2) {
+            compact();
+        }
+        return true;
+    }
+
+    // Prepares for appending count handlers without reallocations
+    void reserve(size_t count) {
+        m_order.reserve(m_order.size() + count);
+        m_priorities.reserve(m_priorities.size() + count);
+        if (m_indexed) {
+            m_index.reserve(m_size + count);
+        } else if (m_size + count > indexThreshold) {
+            // The index would be built halfway through anyway
+            m_index.reserve(m_size + count);
+            buildIndex();
+        }
+    }
+
+    // Removes all handlers, O(n)
+    void clear() {
+        if (m_emissions) {
+            for (size_t i = 0; i < m_order.size(); ++i) {
+                remove(connectionAt(i));
+            }
+            return;
+        }
+        for (uint32_t index : m_order) {
+            if (index == removedPosition) {
+                continue;
+            }
+            Slot &slot = m_slots[index];
+            slot.used = false;
+            if (++slot.generation == 0) {
+                slot.generation = 1;
+            }
+            release(index);
+        }
+        m_order.clear();
+        m_priorities.clear();
+        m_index.clear();
+        m_size = 0;
+        m_removedPositions = 0;
+        m_onceHandlers = 0;
+        m_weakHandlers = 0;
+    }
+
+    // Finds a handler equal to the delegate, O(1) once indexed, O(n) before
+    Connection find(const TDelegate &delegate) const {
+        if (m_indexed) {
+            auto range = m_index.equal_range(std::hash<TDelegate>()(delegate));
+            for (auto it = range.first; it != range.second; ++it) {
+                if (m_slots[it->second].delegate == delegate) {
+                    return Connection(it->second, m_slots[it->second].generation);
+                }
+            }
+            return Connection();
+        }
+        for (uint32_t index : m_order) {
+            if (index == removedPosition || m_slots[index].delegate != delegate) {
+                continue;
+            }
+            return Connection(index, m_slots[index].generation);
+        }
+        return Connection();
+    }
+
+    // Must wrap every emission iterating over positions, the outermost one sorts the order
+    void beginEmission() {
+        if (m_emissions == 0 && m_unsorted) {
+            sort();
+        }
+        ++m_emissions;
+    }
+
+    void endEmission() {
+        if (--m_emissions) {
+            return;
+        }
+        for (uint32_t index : m_retiredSlots) {
+            release(index);
+        }
+        m_retiredSlots.clear();
+        if (m_removedPositions) {
+            compact();
+        }
+    }
+
+    bool isEmitting() const { return m_emissions != 0; }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    HandlerList& operator=(const HandlerList &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    struct Slot {
+        TDelegate delegate;
+        Attachment *attachment = nullptr;
+        int priority = 0;
+        uint32_t generation = 1;
+        uint32_t position = 0;
+        bool once = false;
+        bool weak = false;
+        bool used = false;
+    };
+
+    /**************************************************************************
+     * Constants (Protected)
+     *************************************************************************/
+
+    static constexpr uint32_t removedPosition = ~uint32_t(0);
+
+    // Below this size a scan of the call order beats hashing
+    static constexpr size_t indexThreshold = 16;
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    inline Slot *slotOf(const Connection &connection) {
+        if (connection.index() >= m_slots.size()) {
+            return nullptr;
+        }
+        Slot &slot = m_slots[connection.index()];
+        if (!slot.used || slot.generation != connection.generation()) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    // Appends the slot to the call order, sort() places it by priority
+    void insert(uint32_t index, int priority) {
+        if (!m_order.empty() && priority > m_priorities.back()) {
+            m_unsorted = true;
+        }
+        m_slots[index].position = m_order.size();
+        m_order.push_back(index);
+        m_priorities.push_back(priority);
+    }
+
+    inline void release(uint32_t index) {
+        m_slots[index].delegate.reset();
+        m_freeSlots.push_back(index);
+    }
+
+    void buildIndex() {
+        m_index.reserve(m_size * 2);
+        for (uint32_t index : m_order) {
+            if (index != removedPosition) {
+                m_index.emplace(std::hash<TDelegate>()(m_slots[index].delegate), index);
+            }
+        }
+        m_indexed = true;
+    }
+
+    // Drops the slot from the index, its delegate must still be alive
+    void unindex(uint32_t index) {
+        auto range = m_index.equal_range(std::hash<TDelegate>()(m_slots[index].delegate));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == index) {
+                m_index.erase(it);
+                return;
+            }
+        }
+    }
+
+    // Drops removed positions from the call order, O(n)
+    void compact() {
+        size_t count = 0;
+        for (uint32_t index : m_order) {
+            if (index == removedPosition) {
+                continue;
+            }
+            m_slots[index].position = count;
+            m_priorities[count] = m_slots[index].priority;
+            m_order[count++] = index;
+        }
+        m_order.resize(count);
+        m_priorities.resize(count);
+        m_removedPositions = 0;
+    }
+
+    /* Compacts the call order and restores its priority order. The sorted 
+    prefix is merged with the k handlers after it, O(k log k + n) */
+    void sort() {
+        compact();
+        auto higher = [this] (uint32_t left, uint32_t right) {
+            return m_slots[left].priority > m_slots[right].priority;
+        };
+        auto middle = m_order.begin() + (std::is_sorted_until(m_priorities.begin(), m_priorities.end(), 
+            std::greater<int>()) - m_priorities.begin());
+        std::stable_sort(middle, m_order.end(), higher);
+        std::inplace_merge(m_order.begin(), middle, m_order.end(), higher);
+        for (size_t i = 0; i < m_order.size(); ++i) {
+            m_slots[m_order[i]].position = i;
+            m_priorities[i] = m_slots[m_order[i]].priority;
+        }
+        m_unsorted = false;
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::deque<Slot> m_slots;
+    std::vector<uint32_t> m_order;
+    std::vector<int> m_priorities;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<uint32_t> m_retiredSlots;
+    std::unordered_multimap<size_t, uint32_t> m_index;
+    bool m_indexed = false;
+    bool m_unsorted = false;
+    size_t m_size = 0;
+    size_t m_removedPositions = 0;
+    size_t m_onceHandlers = 0;
+    size_t m_weakHandlers = 0;
+    unsigned int m_emissions = 0;
+};
+
+} // namespace Hlk
+
+#endif // HLK_HANDLER_LIST_H
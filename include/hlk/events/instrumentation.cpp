@@ -0,0 +1,238 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+namespace Hlk {
+
+HLK_EVENTS_INLINE double LatencyHistogram::Snapshot::mean() const {
+    return count ? double(sum) / count : 0.0;
+}
+
+HLK_EVENTS_INLINE uint64_t LatencyHistogram::Snapshot::percentile(double percent) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Rank of the value, the first bucket reaching it holds the percentile
+    uint64_t rank = uint64_t(percent / 100.0 * count);
+    rank = std::min(std::max<uint64_t>(rank, 1), count);
+
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            if (i + 1 == buckets.size()) {
+                return max;
+            }
+            return std::min(bucketLowerBound(i + 1) - 1, max);
+        }
+    }
+    return max;
+}
+
+HLK_EVENTS_INLINE void LatencyHistogram::record(uint64_t value) {
+    Stripe &stripe = m_stripes[threadStripe()];
+    stripe.counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    stripe.sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+HLK_EVENTS_INLINE LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snapshot;
+    snapshot.buckets.resize(bucketCount);
+    for (const Stripe &stripe : m_stripes) {
+        for (unsigned int i = 0; i < bucketCount; ++i) {
+            uint64_t count = stripe.counts[i].load(std::memory_order_relaxed);
+            snapshot.buckets[i] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += stripe.sum.load(std::memory_order_relaxed);
+    }
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+HLK_EVENTS_INLINE void LatencyHistogram::reset() {
+    for (Stripe &stripe : m_stripes) {
+        for (std::atomic<uint64_t> &count : stripe.counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        stripe.sum.store(0, std::memory_order_relaxed);
+    }
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+HLK_EVENTS_INLINE unsigned int LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < subBuckets) {
+        return value;
+    }
+
+    // Index of the highest bit, the next three bits select the sub-bucket
+    unsigned int exponent = 63 - __builtin_clzll(value);
+    if (exponent > maxExponent) {
+        return bucketCount - 1;
+    }
+    return (exponent - 2) * subBuckets + ((value >> (exponent - 3)) & (subBuckets - 1));
+}
+
+HLK_EVENTS_INLINE uint64_t LatencyHistogram::bucketLowerBound(unsigned int bucket) {
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+
+    unsigned int exponent = bucket / subBuckets + 2;
+    return uint64_t(subBuckets + bucket % subBuckets) << (exponent - 3);
+}
+
+HLK_EVENTS_INLINE unsigned int LatencyHistogram::threadStripe() {
+    static std::atomic<unsigned int> threads { 0 };
+    thread_local unsigned int stripe = threads.fetch_add(1, std::memory_order_relaxed) % stripes;
+    return stripe;
+}
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+
+HLK_EVENTS_INLINE EventStats::EventStats() {
+    Instrumentation::registerEvent(this);
+}
+
+HLK_EVENTS_INLINE EventStats::~EventStats() {
+    Instrumentation::unregisterEvent(this);
+}
+
+HLK_EVENTS_INLINE void EventStats::setName(const std::string &name) {
+    m_name.store(Instrumentation::intern(name), std::memory_order_relaxed);
+}
+
+HLK_EVENTS_INLINE std::mutex Instrumentation::m_eventsMutex;
+HLK_EVENTS_INLINE EventStats *Instrumentation::m_events = nullptr;
+HLK_EVENTS_INLINE std::atomic<int64_t> Instrumentation::m_attachments { 0 };
+HLK_EVENTS_INLINE std::atomic<uint64_t> Instrumentation::m_attachmentBackoffs { 0 };
+HLK_EVENTS_INLINE LatencyHistogram Instrumentation::m_attachmentLockWaits;
+
+HLK_EVENTS_INLINE Instrumentation::Snapshot Instrumentation::snapshot() {
+    Snapshot snapshot;
+
+    std::unique_lock lock(m_eventsMutex);
+    for (EventStats *stats = m_events; stats; stats = stats->m_next) {
+        EventSnapshot event;
+        event.event = stats->m_event.load(std::memory_order_relaxed);
+        event.name = stats->name();
+        event.emissions = stats->m_emissions.load(std::memory_order_relaxed);
+        event.handlers = stats->m_handlers.load(std::memory_order_relaxed);
+        event.handlerLatency = stats->m_handlerLatency.snapshot();
+        event.lockWaits = stats->m_lockWaits.snapshot();
+        snapshot.events.push_back(std::move(event));
+    }
+    lock.unlock();
+
+    snapshot.attachments = m_attachments.load(std::memory_order_relaxed);
+    snapshot.attachmentBackoffs = m_attachmentBackoffs.load(std::memory_order_relaxed);
+    snapshot.attachmentLockWaits = m_attachmentLockWaits.snapshot();
+    return snapshot;
+}
+
+HLK_EVENTS_INLINE void Instrumentation::reset() {
+    std::unique_lock lock(m_eventsMutex);
+    for (EventStats *stats = m_events; stats; stats = stats->m_next) {
+        stats->m_emissions.store(0, std::memory_order_relaxed);
+        stats->m_handlerLatency.reset();
+        stats->m_lockWaits.reset();
+    }
+    lock.unlock();
+
+    m_attachmentBackoffs.store(0, std::memory_order_relaxed);
+    m_attachmentLockWaits.reset();
+}
+
+HLK_EVENTS_INLINE const char *Instrumentation::intern(const std::string &name) {
+    // Never destroyed, so names stay valid while static events are destroyed
+    static auto names = new std::unordered_set<std::string>();
+
+    std::unique_lock lock(m_eventsMutex);
+    return names->insert(name).first->c_str();
+}
+
+HLK_EVENTS_INLINE void Instrumentation::registerEvent(EventStats *stats) {
+    std::unique_lock lock(m_eventsMutex);
+    stats->m_next = m_events;
+    if (m_events) {
+        m_events->m_prev = stats;
+    }
+    m_events = stats;
+}
+
+HLK_EVENTS_INLINE void Instrumentation::unregisterEvent(EventStats *stats) {
+    std::unique_lock lock(m_eventsMutex);
+    if (stats->m_prev) {
+        stats->m_prev->m_next = stats->m_next;
+    } else {
+        m_events = stats->m_next;
+    }
+    if (stats->m_next) {
+        stats->m_next->m_prev = stats->m_prev;
+    }
+}
+
+#else
+
+HLK_EVENTS_INLINE Instrumentation::Snapshot Instrumentation::snapshot() {
+    return Snapshot();
+}
+
+HLK_EVENTS_INLINE void Instrumentation::reset() { }
+
+#endif // HLK_EVENTS_INSTRUMENTATION
+
+HLK_EVENTS_INLINE std::string Instrumentation::Snapshot::toString() const {
+    std::ostringstream stream;
+    stream << "events " << events.size()
+           << ", attachments " << attachments
+           << ", backoffs " << attachmentBackoffs
+           << ", attachment lock waits " << attachmentLockWaits.count
+           << " p99 " << attachmentLockWaits.percentile(99) << '\n';
+    for (const EventSnapshot &event : events) {
+        stream << "event " << event.event;
+        if (!event.name.empty()) {
+            stream << ' ' << event.name;
+        }
+        stream << ": emissions " << event.emissions 
+               << ", handlers " << event.handlers
+               << ", calls " << event.handlerLatency.count
+               << " p50 " << event.handlerLatency.percentile(50)
+               << " p99 " << event.handlerLatency.percentile(99)
+               << " max " << event.handlerLatency.max
+               << ", lock waits " << event.lockWaits.count
+               << " p99 " << event.lockWaits.percentile(99)
+               << " max " << event.lockWaits.max << '\n';
+    }
+    return stream.str();
+}
+
+} // namespace Hlk
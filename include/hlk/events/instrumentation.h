@@ -0,0 +1,410 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_INSTRUMENTATION_H
+#define HLK_INSTRUMENTATION_H
+
+#include "abstractevent.h"
+#include "config.h"
+#include "tracer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Hlk {
+
+class NotifiableObject;
+
+/**
+ * @brief Latency histogram with lock-free striped counters
+ * 
+ * HDR-style log-linear buckets: values below 8 have a bucket each, above 
+ * that every power of two is split into 8 buckets, so a value is known with 
+ * 12.5% precision up to 2^35 ns (about 34 seconds), larger values share the 
+ * last bucket. Threads are spread over a few stripes of counters which they 
+ * increment with relaxed atomics, a snapshot sums the stripes.
+ */
+class LatencyHistogram {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        std::vector<uint64_t> buckets;
+
+        double mean() const;
+
+        // Upper bound of the bucket holding the percentile, 0 if empty
+        uint64_t percentile(double percent) const;
+    };
+
+    /**************************************************************************
+     * Constants
+     *************************************************************************/
+
+    static constexpr unsigned int subBuckets = 8;
+    static constexpr unsigned int maxExponent = 35;
+    static constexpr unsigned int bucketCount = (maxExponent - 1) * subBuckets;
+    static constexpr unsigned int stripes = 4;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    void record(uint64_t value);
+    Snapshot snapshot() const;
+    void reset();
+
+    static unsigned int bucketOf(uint64_t value);
+    static uint64_t bucketLowerBound(unsigned int bucket);
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    struct alignas(64) Stripe {
+        std::atomic<uint64_t> counts[bucketCount] {};
+        std::atomic<uint64_t> sum { 0 };
+    };
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    // Stripe of the calling thread, threads take them in turn
+    static unsigned int threadStripe();
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    Stripe m_stripes[stripes];
+    std::atomic<uint64_t> m_max { 0 };
+};
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+
+// Measures nanoseconds since its construction
+class Stopwatch {
+public:
+    Stopwatch() : m_start(Tracer::Clock::now()) { }
+
+    // Reads the clock only if started, e.g. while the tracer records
+    explicit Stopwatch(bool started) {
+        if (started) {
+            m_start = Tracer::Clock::now();
+        }
+    }
+
+    bool isStarted() const { return m_start != Tracer::Clock::time_point(); }
+
+    Tracer::Clock::time_point start() const { return m_start; }
+
+    uint64_t elapsed() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Tracer::Clock::now() - m_start).count();
+    }
+
+protected:
+    Tracer::Clock::time_point m_start;
+};
+
+/**
+ * @brief Counters of one event
+ * 
+ * Kept in the state of the event, so an event is tracked from its first 
+ * subscription. Registered in Instrumentation while it exists. The latency 
+ * of all handlers of the event goes to one histogram, since a histogram 
+ * takes about 9 KB and one per handler would multiply that by the number of 
+ * handlers. A slow handler is found by naming the events or in a trace.
+ */
+class EventStats {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    EventStats();
+    EventStats(const EventStats &other) = delete;
+    ~EventStats();
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // The event owning the stats, it changes when the event is moved
+    void setEvent(const AbstractEvent *event) {
+        m_event.store(event, std::memory_order_relaxed);
+    }
+
+    /* Name of the event in snapshots and traces. Distinct names are kept 
+    until the process exits, since recorded traces point to them after the 
+    event is destroyed, so don't give events names built at runtime */
+    void setName(const std::string &name);
+
+    const char *name() const {
+        const char *name = m_name.load(std::memory_order_relaxed);
+        return name ? name : "";
+    }
+
+    // Counts the emission, the stopwatch times it for the tracer
+    Stopwatch beginEmission(size_t handlers) {
+        m_emissions.fetch_add(1, std::memory_order_relaxed);
+        m_handlers.store(handlers, std::memory_order_relaxed);
+        return Stopwatch(Tracer::isRecording());
+    }
+
+    void endEmission(const Stopwatch &stopwatch) {
+        if (stopwatch.isStarted()) {
+            Tracer::record(Tracer::Kind::Emission, m_name.load(std::memory_order_relaxed), 
+                m_event.load(std::memory_order_relaxed), nullptr, stopwatch.start(), stopwatch.elapsed());
+        }
+    }
+
+    void recordHandler(const Stopwatch &stopwatch) {
+        uint64_t elapsed = stopwatch.elapsed();
+        m_handlerLatency.record(elapsed);
+        if (Tracer::isRecording()) {
+            Tracer::record(Tracer::Kind::Handler, m_name.load(std::memory_order_relaxed), 
+                m_event.load(std::memory_order_relaxed), nullptr, stopwatch.start(), elapsed);
+        }
+    }
+
+    // Locks the mutex of the event, the time is recorded if it was busy
+    template<class TLock>
+    void acquire(TLock &lock) {
+        if (lock.try_lock()) {
+            return;
+        }
+        Stopwatch stopwatch;
+        lock.lock();
+        m_lockWaits.record(stopwatch.elapsed());
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    EventStats& operator=(const EventStats &other) = delete;
+
+protected:
+    friend class Instrumentation;
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::atomic<const AbstractEvent *> m_event { nullptr };
+    std::atomic<const char *> m_name { nullptr };
+    std::atomic<uint64_t> m_emissions { 0 };
+    std::atomic<size_t> m_handlers { 0 };
+
+    // Latency of every handler of the event
+    LatencyHistogram m_handlerLatency;
+    LatencyHistogram m_lockWaits;
+    EventStats *m_prev = nullptr;
+    EventStats *m_next = nullptr;
+};
+
+#else
+
+// Without instrumentation the hooks are empty and compile to nothing
+
+class Stopwatch {
+public:
+    Stopwatch() = default;
+    explicit Stopwatch(bool) { }
+};
+
+class EventStats {
+public:
+    void setEvent(const AbstractEvent *) { }
+    void setName(const std::string &) { }
+    const char *name() const { return ""; }
+    Stopwatch beginEmission(size_t) { return Stopwatch(); }
+    void endEmission(const Stopwatch &) { }
+    void recordHandler(const Stopwatch &) { }
+
+    template<class TLock>
+    void acquire(TLock &lock) {
+        lock.lock();
+    }
+};
+
+#endif // HLK_EVENTS_INSTRUMENTATION
+
+/**
+ * @brief Snapshot of the counters of the library
+ * 
+ * Built with HLK_EVENTS_INSTRUMENTATION defined (the ENABLE_INSTRUMENTATION 
+ * CMake option), the library records the emissions of every subscribed 
+ * event, the latency of each handler call, the time emissions wait for the 
+ * lock of a busy event and the attachments of notifiable objects. Without 
+ * it the hooks compile to nothing and snapshot() is empty.
+ */
+class Instrumentation {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    struct EventSnapshot {
+        const AbstractEvent *event = nullptr;
+
+        // Given by Event::setName(), empty if none
+        std::string name;
+        uint64_t emissions = 0;
+
+        // Handlers attached at the last emission
+        size_t handlers = 0;
+
+        // Calls of all handlers of the event together
+        LatencyHistogram::Snapshot handlerLatency;
+        LatencyHistogram::Snapshot lockWaits;
+    };
+
+    struct Snapshot {
+        std::vector<EventSnapshot> events;
+
+        // Live handlers of notifiable objects
+        int64_t attachments = 0;
+
+        // Times a destroyed notifiable found an event busy and retried
+        uint64_t attachmentBackoffs = 0;
+        LatencyHistogram::Snapshot attachmentLockWaits;
+
+        // One line per event, latencies in nanoseconds
+        std::string toString() const;
+    };
+
+    /**************************************************************************
+     * Constants
+     *************************************************************************/
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Counters of the events which exist now and of the dispatcher
+    static Snapshot snapshot();
+
+    // Zeroes the counters, the number of attachments stays
+    static void reset();
+
+    // Hooks of EventDispatcher
+
+    template<class TLock>
+    static void acquireAttachments(TLock &lock) {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        if (lock.try_lock()) {
+            return;
+        }
+        Stopwatch stopwatch;
+        lock.lock();
+        m_attachmentLockWaits.record(stopwatch.elapsed());
+#else
+        lock.lock();
+#endif
+    }
+
+    static void attachmentAdded(const AbstractEvent *event, const NotifiableObject *notifiable) {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        m_attachments.fetch_add(1, std::memory_order_relaxed);
+        if (Tracer::isRecording()) {
+            Tracer::record(Tracer::Kind::Attach, event->name(), event, notifiable, Tracer::Clock::now());
+        }
+#endif
+    }
+
+    static void attachmentRemoved(const AbstractEvent *event, const NotifiableObject *notifiable) {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        m_attachments.fetch_sub(1, std::memory_order_relaxed);
+        if (Tracer::isRecording()) {
+            Tracer::record(Tracer::Kind::Detach, event->name(), event, notifiable, Tracer::Clock::now());
+        }
+#endif
+    }
+
+    // The stopwatch is started by NotifiableObject teardown while tracing
+    static void notifiableDestroyed(const NotifiableObject *notifiable, const Stopwatch &stopwatch) {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        if (stopwatch.isStarted()) {
+            Tracer::record(Tracer::Kind::NotifiableDestroyed, nullptr, nullptr, notifiable, 
+                stopwatch.start(), stopwatch.elapsed());
+        }
+#endif
+    }
+
+    static void attachmentBackoff() {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        m_attachmentBackoffs.fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+protected:
+    friend class EventStats;
+
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    static void registerEvent(EventStats *stats);
+    static void unregisterEvent(EventStats *stats);
+
+    // Copy of the name which lives as long as the process, equal names share it
+    static const char *intern(const std::string &name);
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    static std::mutex m_eventsMutex;
+    static EventStats *m_events;
+    static std::atomic<int64_t> m_attachments;
+    static std::atomic<uint64_t> m_attachmentBackoffs;
+    static LatencyHistogram m_attachmentLockWaits;
+#endif
+};
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "instrumentation.cpp"
+#endif
+
+#endif // HLK_INSTRUMENTATION_H
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin 
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under 
+ * the terms of the GNU Lesser General Public License as pubblished by the 
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT 
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more 
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License 
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+#ifndef HLK_KEYED_EVENT_H
+#define HLK_KEYED_EVENT_H
+
+#include "event.h"
+
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Hlk {
+
+/**
+ * @brief Event whose handlers subscribe to a key and are called only by 
+ * emissions of that key
+ * 
+ * Each key has its own Event<TArgs...>, found by a hash lookup, so an 
+ * emission costs the lookup and the handlers of its key regardless of how 
+ * many handlers other keys have. Handlers are attached and removed with 
+ * the arguments of Event::addEventHandler() and removeEventHandler() 
+ * preceded by the key, with the same guarantees: handlers of notifiable 
+ * objects are removed when the objects are destroyed, an emission may 
+ * attach and remove handlers of any key, erase its own key or destroy the 
+ * KeyedEvent. The key map is locked only for the lookup. A key is dropped 
+ * when removeEventHandler() removes its last handler. Handlers removed with 
+ * their destroyed notifiable objects leave the key in place until prune().
+ * 
+ * @tparam TKey key type, hashed with std::hash
+ * @tparam TArgs event arguments
+ */
+template<class TKey, class... TArgs>
+class KeyedEvent {
+    using TEvent = Event<TArgs...>;
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    KeyedEvent() = default;
+    KeyedEvent(const KeyedEvent &other) = delete;
+    KeyedEvent(KeyedEvent && other) = delete;
+    ~KeyedEvent() = default;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    /**
+     * @brief Attaches a handler called by emissions of the key
+     * 
+     * @param key key the handler subscribes to
+     * @param handler arguments of Event::addEventHandler(), e.g. an object 
+     * and its method, a lambda and its priority
+     * @return connection of the handler, valid together with the key
+     */
+    template<class... THandler>
+    Connection addEventHandler(const TKey &key, THandler &&... handler) {
+        // Locked until the handler is added, so the key can't be dropped meanwhile
+        std::unique_lock lock(m_mutex);
+        std::shared_ptr<TEvent> &event = m_events[key];
+        if (!event) {
+            event = std::make_shared<TEvent>();
+        }
+        return event->addEventHandler(std::forward<THandler>(handler)...);
+    }
+
+    // Removes a handler of the key and the key with its last handler
+    template<class... THandler>
+    void removeEventHandler(const TKey &key, THandler &&... handler) {
+        std::unique_lock lock(m_mutex);
+        auto it = m_events.find(key);
+        if (it == m_events.end()) {
+            return;
+        }
+        it->second->removeEventHandler(std::forward<THandler>(handler)...);
+        if (it->second->size() == 0) {
+            m_events.erase(it);
+        }
+    }
+
+    // Calls the handlers of the key, O(1) plus the matching handlers
+    void emit(const TKey &key, TArgs... args) {
+        // The event outlives the erasure of its key during the emission
+        if (std::shared_ptr<TEvent> event = find(key)) {
+            (*event)(std::forward<TArgs>(args)...);
+        }
+    }
+
+    // Removes the key with all its handlers
+    void erase(const TKey &key) {
+        std::unique_lock lock(m_mutex);
+        m_events.erase(key);
+    }
+
+    // Removes all keys and handlers
+    void clear() {
+        std::unique_lock lock(m_mutex);
+        m_events.clear();
+    }
+
+    // Drops keys left without handlers by destroyed notifiable objects, O(keys)
+    void prune() {
+        std::unique_lock lock(m_mutex);
+        for (auto it = m_events.begin(); it != m_events.end();) {
+            it = it->second->size() == 0 ? m_events.erase(it) : std::next(it);
+        }
+    }
+
+    // Number of keys with handlers, see prune()
+    size_t size() const {
+        std::unique_lock lock(m_mutex);
+        return m_events.size();
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    // Emits the key, see emit()
+    void operator()(const TKey &key, TArgs... args) {
+        emit(key, std::forward<TArgs>(args)...);
+    }
+
+    KeyedEvent& operator=(const KeyedEvent &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Event of the key or nullptr if nobody subscribed to it
+    std::shared_ptr<TEvent> find(const TKey &key) const {
+        std::unique_lock lock(m_mutex);
+        auto it = m_events.find(key);
+        return it == m_events.end() ? nullptr : it->second;
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<TKey, std::shared_ptr<TEvent>> m_events;
+};
+
+} // namespace Hlk
+
+#endif // HLK_KEYED_EVENT_H
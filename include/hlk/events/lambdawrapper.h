@@ -25,6 +25,8 @@
 
 #include "abstractwrapper.h"
 
+#include <cstring>
+
 namespace Hlk {
 
 template<class TLambda, class TFunction>
@@ -38,77 +40,98 @@ public:
      * Constructors / Destructors
      *************************************************************************/
 
-    LambdaWrapper() = default;
+    // Auto-bind constructor
+    LambdaWrapper(TLambda && lambda) 
+    : m_lambda(std::move(lambda)) {
+        identify();
+    }
 
-    // Copy constructor
-    LambdaWrapper(const LambdaWrapper &other) { 
-        m_lambda = new TLambda(*(other.m_lambda)); 
+    LambdaWrapper(const TLambda &lambda) 
+    : m_lambda(lambda) {
+        identify();
     }
 
+    // Copy constructor
+    LambdaWrapper(const LambdaWrapper &other) 
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_lambda(other.m_lambda) { }
+
     // Move constructor
-    LambdaWrapper(LambdaWrapper&& other) 
-    : m_lambda(other.m_lambda) {
-        other.m_lambda = nullptr;
-    }
+    LambdaWrapper(LambdaWrapper&& other) noexcept(std::is_nothrow_move_constructible_v<TLambda>)
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_lambda(std::move(other.m_lambda)) { }
 
-    virtual ~LambdaWrapper() {
-        delete m_lambda;
-    }
+    virtual ~LambdaWrapper() = default;
 
     /**************************************************************************
      * Methods
      *************************************************************************/
 
-    virtual TLWrapper* clone() override { 
-        return new TLWrapper(*this); 
+    virtual AbstractWrapper<TReturn(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TLWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<TReturn(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TLWrapper>(storage, *this);
     }
 
-    void bind(TLambda && lambda) { 
-        m_lambda = new TLambda(lambda);
+    virtual void destroy() override {
+        this->template dispose<TLWrapper>(this);
     }
 
     /**************************************************************************
      * Overloaded operators
      *************************************************************************/
 
-    virtual TReturn operator()(TArgs... args) override {
-        return m_lambda->operator()(args...);
-    }
-
-    // Copy assignment operator
-    LambdaWrapper& operator=(const LambdaWrapper &other) {
-        if (this == &other) {
-            return *this;
-        }
-        m_lambda = other.m_lambda;
-        return *this;
+    virtual TReturn operator()(TArgs&&... args) override {
+        return m_lambda(std::forward<TArgs>(args)...);
     }
 
-    // Move assignment operator
-    LambdaWrapper& operator=(LambdaWrapper&& other) {
-        if (this == &other) {
-            return *this;
-        }
-        m_lambda = other.m_lambda;
-        other.m_lambda = nullptr;
-        return *this;
-    }
+    /* Lambdas with captures are not assignable, so the wrapper is rebound by
+    constructing a new one instead */
+    LambdaWrapper& operator=(const LambdaWrapper &other) = delete;
+    LambdaWrapper& operator=(LambdaWrapper&& other) = delete;
 
 protected:
+    /**************************************************************************
+     * Constants (Protected)
+     *************************************************************************/
+
+    /* Captureless lambdas of one type are interchangeable and trivially
+    copyable ones are compared bytewise, which at worst misses a duplicate
+    differing only in padding. Other lambdas (e.g. with a captured
+    std::string) are only equal to themselves */
+    static constexpr bool isStateless = std::is_empty_v<TLambda>;
+    static constexpr bool isBytewiseComparable = std::is_trivially_copyable_v<TLambda>;
+
     /**************************************************************************
      * Method (Protected)
      *************************************************************************/
 
     virtual bool isEquals(const AbstractWrapper<TReturn(TArgs...)> &other) const override {
-        const TLWrapper *otherPtr = dynamic_cast<const TLWrapper *>(&other);
-        return otherPtr != nullptr && m_lambda == otherPtr->m_lambda;
+        const TLWrapper &otherWrapper = static_cast<const TLWrapper &>(other);
+        if constexpr (isStateless) {
+            return true;
+        } else if constexpr (isBytewiseComparable) {
+            return std::memcmp(&m_lambda, &otherWrapper.m_lambda, sizeof(TLambda)) == 0;
+        } else {
+            return &m_lambda == &otherWrapper.m_lambda;
+        }
+    }
+
+    void identify() {
+        this->m_tag = this->template typeTag<TLWrapper>();
+        this->m_hash = reinterpret_cast<std::size_t>(this->m_tag);
+        if constexpr (!isStateless && isBytewiseComparable) {
+            this->m_hash = this->hashBytes(&m_lambda, sizeof(TLambda), this->m_hash);
+        }
     }
 
     /**************************************************************************
      * Members
      *************************************************************************/
 
-    TLambda *m_lambda = nullptr;
+    TLambda m_lambda;
 };
 
 } // namespace Hlk
@@ -47,12 +47,14 @@ public:
 
     // Copy constructor
     MethodWrapper(const MethodWrapper &other) 
-    : m_object(other.m_object),
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_object(other.m_object),
       m_method(other.m_method) { }
 
     // Move constructor
-    MethodWrapper(MethodWrapper && other) 
-    : m_object(other.m_object),
+    MethodWrapper(MethodWrapper && other) noexcept
+    : AbstractWrapper<TReturn(TArgs...)>(other),
+      m_object(other.m_object),
       m_method(other.m_method) {
         other.m_object = nullptr;
         other.m_method = nullptr;
@@ -64,21 +66,32 @@ public:
      * Methods
      *************************************************************************/
 
-    virtual TMWrapper* clone() override { 
-        return new TMWrapper(*this); 
+    virtual AbstractWrapper<TReturn(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TMWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<TReturn(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TMWrapper>(storage, *this);
+    }
+
+    virtual void destroy() override {
+        this->template dispose<TMWrapper>(this);
     }
 
     void bind(TClass *object, TReturn (TClass::*method)(TArgs...)) {
         m_object = object;
         m_method = method;
+        this->m_tag = this->template typeTag<TMWrapper>();
+        this->m_hash = this->hashBytes(&m_method, sizeof(m_method),
+            this->hashBytes(&m_object, sizeof(m_object), reinterpret_cast<std::size_t>(this->m_tag)));
     }
 
     /**************************************************************************
      * Overloaded operators
      *************************************************************************/
 
-    virtual TReturn operator()(TArgs... args) override {
-        return (m_object->*m_method)(args...);
+    virtual TReturn operator()(TArgs&&... args) override {
+        return (m_object->*m_method)(std::forward<TArgs>(args)...);
     }
 
     // Copy assignment operator
@@ -86,6 +99,7 @@ public:
         if (this == &other) {
             return *this;
         }
+        AbstractWrapper<TReturn(TArgs...)>::operator=(other);
         m_object = other.m_object;
         m_method = other.m_method;
         return *this;
@@ -96,6 +110,7 @@ public:
         if (this == &other) {
             return *this;
         }
+        AbstractWrapper<TReturn(TArgs...)>::operator=(other);
         m_object = other.m_object;
         m_method = other.m_method;
         other.m_object = nullptr;
@@ -109,10 +124,8 @@ protected:
      *************************************************************************/
 
     virtual bool isEquals(const AbstractWrapper<TReturn(TArgs...)> &other) const override {
-        const TMWrapper *otherPtr = dynamic_cast<const TMWrapper *>(&other);
-        return otherPtr != nullptr
-            && m_object == otherPtr->m_object
-            && m_method == otherPtr->m_method;
+        const TMWrapper &otherWrapper = static_cast<const TMWrapper &>(other);
+        return m_object == otherWrapper.m_object && m_method == otherWrapper.m_method;
     }
 
     /**************************************************************************
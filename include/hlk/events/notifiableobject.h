@@ -23,21 +23,97 @@
 #ifndef HLK_NOTIFIABLE_OBJECT_H
 #define HLK_NOTIFIABLE_OBJECT_H
 
+#include "attachment.h"
 #include "eventdispatcher.h"
 
+#include <memory>
+#include <mutex>
+
 namespace Hlk {
 
+class EventLoop;
+
+template<class TFunction>
+class QueuedWrapper;
+
 class NotifiableObject {
 public:
     /**************************************************************************
      * Constructors / Destructors
      *************************************************************************/
 
+    NotifiableObject() = default;
+
+    // Attachments belong to the instance, so a copy starts without them
+    NotifiableObject(const NotifiableObject &other) { 
+        if (EventLoop *loop = other.eventLoop()) {
+            setEventLoop(loop);
+        }
+    }
+
+    // Drops the calls still queued to the event loop, destroy on its thread
     virtual ~NotifiableObject() {
+        m_eventLoop.reset();
         EventDispatcher::getInstance()->notifiableDestroyed(this);
     }
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    EventLoop *eventLoop() const {
+        return m_eventLoop ? *m_eventLoop : nullptr;
+    }
+
+    /**
+     * @brief Binds handlers of the object to the event loop
+     * 
+     * Method handlers and lambdas with the object as a context run on the 
+     * loop thread, see EventLoop. Affects handlers attached afterwards, so 
+     * the loop is usually set in the constructor.
+     * 
+     * @param loop event loop, nullptr to call handlers on the emitting thread
+     */
+    void setEventLoop(EventLoop *loop) {
+        if (!m_eventLoop) {
+            m_eventLoop = std::make_shared<EventLoop *>(loop);
+        } else {
+            *m_eventLoop = loop;
+        }
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    /* Keeps the attachments and the event loop of the object, unlike the 
+    copy constructor, since handlers already attached are bound to the loop */
+    NotifiableObject& operator=(const NotifiableObject &) {
+        return *this;
+    }
+
+private:
+    friend class EventDispatcher;
+
+    template<class TFunction>
+    friend class QueuedWrapper;
+
+    /**************************************************************************
+     * Members (Private)
+     *************************************************************************/
+
+    std::mutex m_attachmentsMutex;
+    Attachment *m_attachments = nullptr;
+
+    /* Shared with the calls queued to the loop, which are dropped once the 
+    object is destroyed */
+    std::shared_ptr<EventLoop *> m_eventLoop;
 };
 
 } // namespace Hlk
 
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "eventdispatcher.cpp"
+#endif
+
 #endif // HLK_NOTIFIABLE_OBJECT_H
\ No newline at end of file
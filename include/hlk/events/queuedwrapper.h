@@ -0,0 +1,159 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_QUEUED_WRAPPER_H
+#define HLK_QUEUED_WRAPPER_H
+
+#include "delegate.h"
+#include "eventloop.h"
+#include "notifiableobject.h"
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace Hlk {
+
+template<class TFunction>
+class QueuedWrapper;
+
+/**
+ * @brief Wrapper calling a handler on the thread of an event loop
+ * 
+ * Calls made on the loop thread are direct, calls from other threads copy 
+ * the arguments and are posted to the loop. Posted calls are dropped once 
+ * the lifetime token of the handler owner expires.
+ */
+template<class... TArgs>
+class QueuedWrapper<void(TArgs...)> : public AbstractWrapper<void(TArgs...)> {
+    using TQWrapper = QueuedWrapper<void(TArgs...)>;
+    using TDelegate = Delegate<void(TArgs...)>;
+    using TArguments = std::tuple<std::decay_t<TArgs>...>;
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    QueuedWrapper(TDelegate &&handler, EventLoop *loop, std::weak_ptr<void> lifetime)
+    : m_handler(std::move(handler)),
+      m_loop(loop),
+      m_lifetime(std::move(lifetime)) {
+        this->m_tag = this->template typeTag<TQWrapper>();
+        std::size_t hash = m_handler.hash();
+        this->m_hash = this->hashBytes(&hash, sizeof(hash), reinterpret_cast<std::size_t>(this->m_tag));
+    }
+
+    // Copy constructor
+    QueuedWrapper(const QueuedWrapper &other) 
+    : AbstractWrapper<void(TArgs...)>(other),
+      m_handler(other.m_handler),
+      m_loop(other.m_loop),
+      m_lifetime(other.m_lifetime) { }
+
+    // Move constructor
+    QueuedWrapper(QueuedWrapper&& other) noexcept
+    : AbstractWrapper<void(TArgs...)>(other),
+      m_handler(std::move(other.m_handler)),
+      m_loop(other.m_loop),
+      m_lifetime(std::move(other.m_lifetime)) { }
+
+    virtual ~QueuedWrapper() = default;
+
+    /**************************************************************************
+     * Static methods
+     *************************************************************************/
+
+    // Handler of the object, queued to its event loop if it has one
+    static TDelegate bind(TDelegate &&handler, NotifiableObject *object) {
+        EventLoop *loop = object ? object->eventLoop() : nullptr;
+        if (loop == nullptr) {
+            return std::move(handler);
+        }
+
+        TDelegate queued;
+        queued.template emplace<TQWrapper>(std::move(handler), loop, object->m_eventLoop);
+        return queued;
+    }
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    virtual AbstractWrapper<void(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TQWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<void(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TQWrapper>(storage, *this);
+    }
+
+    virtual void destroy() override {
+        this->template dispose<TQWrapper>(this);
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    virtual void operator()(TArgs&&... args) override {
+        if (m_loop->isInLoopThread()) {
+            m_handler.invoke(std::forward<TArgs>(args)...);
+            return;
+        }
+
+        // References are copied too, the caller doesn't wait for the call
+        m_loop->post([handler = m_handler, lifetime = m_lifetime, 
+            args = TArguments(std::forward<TArgs>(args)...)] () mutable {
+            if (lifetime.expired()) {
+                return;
+            }
+            std::apply([&handler] (auto &... values) {
+                handler.invoke(std::forward<TArgs>(values)...);
+            }, args);
+        });
+    }
+
+    QueuedWrapper& operator=(const QueuedWrapper &other) = delete;
+    QueuedWrapper& operator=(QueuedWrapper&& other) = delete;
+
+protected:
+    /**************************************************************************
+     * Method (Protected)
+     *************************************************************************/
+
+    virtual bool isEquals(const AbstractWrapper<void(TArgs...)> &other) const override {
+        auto &wrapper = static_cast<const TQWrapper &>(other);
+        return m_loop == wrapper.m_loop && m_handler == wrapper.m_handler;
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    TDelegate m_handler;
+    EventLoop *m_loop;
+    std::weak_ptr<void> m_lifetime;
+};
+
+} // namespace Hlk
+
+#endif // HLK_QUEUED_WRAPPER_H
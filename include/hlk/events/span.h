@@ -0,0 +1,100 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_SPAN_H
+#define HLK_SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Hlk {
+
+/**
+ * @brief Non-owning view of a contiguous sequence, a subset of C++20 std::span
+ * 
+ * Constructible from any container with data() and size(), including 
+ * std::vector, std::array and std::span. A span of const elements also views 
+ * const and temporary containers, e.g. emitBatch(std::vector<int> { 1, 2 }), 
+ * and must not outlive them.
+ */
+template<class T>
+class Span {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    constexpr Span() = default;
+
+    constexpr Span(T *data, std::size_t size)
+    : m_data(data),
+      m_size(size) { }
+
+    template<std::size_t N>
+    constexpr Span(T (&array)[N])
+    : m_data(array),
+      m_size(N) { }
+
+    template<class TContainer, class = std::enable_if_t<
+        std::is_convertible_v<decltype(std::declval<TContainer &>().data()), T *>
+        && !std::is_same_v<std::decay_t<TContainer>, Span>>>
+    constexpr Span(TContainer &container)
+    : m_data(container.data()),
+      m_size(container.size()) { }
+
+    template<class TContainer, class = std::enable_if_t<
+        std::is_convertible_v<decltype(std::declval<const TContainer &>().data()), T *>
+        && !std::is_same_v<std::decay_t<TContainer>, Span>>>
+    constexpr Span(const TContainer &container)
+    : m_data(container.data()),
+      m_size(container.size()) { }
+
+    /**************************************************************************
+     * Accessors / Mutators
+     *************************************************************************/
+
+    constexpr T *data() const { return m_data; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+
+    constexpr T *begin() const { return m_data; }
+    constexpr T *end() const { return m_data + m_size; }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    constexpr T &operator[](std::size_t index) const { return m_data[index]; }
+
+protected:
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    T *m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+} // namespace Hlk
+
+#endif // HLK_SPAN_H
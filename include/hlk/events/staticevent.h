@@ -0,0 +1,105 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_STATIC_EVENT_H
+#define HLK_STATIC_EVENT_H
+
+#include <functional>
+#include <type_traits>
+
+namespace Hlk {
+
+/**
+ * @brief Event with handlers fixed at compile time
+ * 
+ * Handlers are non-type template parameters and the emission expands to 
+ * direct calls of them in the order of declaration, so the event has no 
+ * state and no indirection. A handler may be:
+ * - a function pointer, called with the emission arguments;
+ * - a method pointer, called on the object passed as the first argument;
+ * - a pointer to a member event or other callable member, called on the 
+ * object passed as the first argument with the remaining arguments;
+ * - a pointer to a callable object with static storage duration, e.g. a 
+ * global Event, called with the emission arguments.
+ * 
+ * A StaticEvent is itself a stateless callable, so it can be attached to a 
+ * dynamic Event with addEventHandler() as any lambda.
+ * 
+ * @tparam Handlers handlers called on emission
+ */
+template<auto... Handlers>
+class StaticEvent {
+public:
+    /**************************************************************************
+     * Static methods
+     *************************************************************************/
+
+    // Number of handlers
+    static constexpr std::size_t size() {
+        return sizeof...(Handlers);
+    }
+
+    template<class... TArgs>
+    static inline void emit(TArgs &&... args) {
+        (invoke<Handlers>(args...), ...);
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    template<class... TArgs>
+    inline void operator()(TArgs &&... args) const {
+        emit(args...);
+    }
+
+protected:
+    /**************************************************************************
+     * Static methods (Protected)
+     *************************************************************************/
+
+    // Arguments are passed as lvalues, so no handler can consume them
+    template<auto Handler, class... TArgs>
+    static inline void invoke(TArgs &... args) {
+        using THandler = decltype(Handler);
+        if constexpr (std::is_member_function_pointer_v<THandler>) {
+            std::invoke(Handler, args...);
+        } else if constexpr (std::is_member_object_pointer_v<THandler>) {
+            invokeMember<Handler>(args...);
+        } else if constexpr (std::is_function_v<std::remove_pointer_t<THandler>>) {
+            Handler(args...);
+        } else {
+            static_assert(std::is_pointer_v<THandler>, "StaticEvent handler must be a function, a member "
+                "pointer or a pointer to a callable object");
+            (*Handler)(args...);
+        }
+    }
+
+    template<auto Handler, class TObject, class... TArgs>
+    static inline void invokeMember(TObject &object, TArgs &... args) {
+        std::invoke(Handler, object)(args...);
+    }
+};
+
+} // namespace Hlk
+
+#endif // HLK_STATIC_EVENT_H
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_THREADING_POLICY_H
+#define HLK_THREADING_POLICY_H
+
+#include "config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Hlk {
+
+// Lock of events which are only touched by one thread, does nothing
+class NullMutex {
+public:
+    void lock() { }
+    bool try_lock() { return true; }
+    void unlock() { }
+};
+
+/**
+ * @brief Test-and-test-and-set spinlock
+ * 
+ * One byte. Waiting threads spin on a plain load and yield to the scheduler 
+ * after a few rounds, so it suits events whose handlers are attached and 
+ * emitted by several threads but the lock is held only briefly.
+ */
+class SpinMutex {
+public:
+    void lock() {
+        unsigned int spins = 0;
+        while (m_locked.exchange(true, std::memory_order_acquire)) {
+            // Waits for the unlock without writing to the cache line
+            while (m_locked.load(std::memory_order_relaxed)) {
+                if (++spins > 64) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    bool try_lock() {
+        return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() {
+        m_locked.store(false, std::memory_order_release);
+    }
+
+protected:
+    std::atomic<bool> m_locked { false };
+};
+
+/**
+ * @brief Lock of one word whose waiting threads sleep on a futex
+ * 
+ * Four bytes instead of the forty of std::mutex, an uncontended lock and 
+ * unlock are one inlined atomic operation each. The word is 0 when unlocked, 
+ * 1 when locked and 2 when some thread may be waiting, only then unlock() 
+ * makes a system call. Outside Linux waiting threads yield instead.
+ */
+class FutexMutex {
+public:
+    void lock() {
+        uint32_t state = 0;
+        if (m_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
+        }
+        if (state != 2) {
+            state = m_state.exchange(2, std::memory_order_acquire);
+        }
+        while (state != 0) {
+            wait();
+            state = m_state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    bool try_lock() {
+        uint32_t state = 0;
+        return m_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() {
+        if (m_state.exchange(0, std::memory_order_release) == 2) {
+            wake();
+        }
+    }
+
+protected:
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Sleeps while the word is 2
+    void wait();
+
+    // Wakes one waiting thread
+    void wake();
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::atomic<uint32_t> m_state { 0 };
+};
+
+/**
+ * @brief Threading model of an event, see Event<ThreadingPolicy<...>, TArgs...>
+ * 
+ * @tparam TMutex lock guarding the handlers, std::mutex, FutexMutex, 
+ * SpinMutex, NullMutex or any class with lock(), try_lock() and unlock()
+ * @tparam trackObjects whether handlers of notifiable objects are removed 
+ * when the objects are destroyed. Without it the event never calls 
+ * EventDispatcher and the objects must remove their handlers themselves
+ */
+template<class TMutex, bool trackObjects = true>
+struct ThreadingPolicy {
+    using Mutex = TMutex;
+    static constexpr bool tracksObjects = trackObjects;
+};
+
+// The default, any thread may use the event
+using MultiThreaded = ThreadingPolicy<std::mutex>;
+using FutexLocked = ThreadingPolicy<FutexMutex>;
+using SpinLocked = ThreadingPolicy<SpinMutex>;
+
+// No locking, the event and the objects of its handlers stay on one thread
+using SingleThreaded = ThreadingPolicy<NullMutex>;
+
+// No locking and no removal of handlers of destroyed notifiable objects
+using SingleThreadedUntracked = ThreadingPolicy<NullMutex, false>;
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "threadingpolicy.cpp"
+#endif
+
+#endif // HLK_THREADING_POLICY_H
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#include "threadpool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+namespace Hlk {
+
+HLK_EVENTS_INLINE std::mutex ThreadPool::m_instanceMutex;
+HLK_EVENTS_INLINE ThreadPool *ThreadPool::m_instance = nullptr;
+HLK_EVENTS_INLINE unsigned int ThreadPool::m_instanceWorkers = 0;
+HLK_EVENTS_INLINE std::vector<int> ThreadPool::m_instanceAffinity;
+
+HLK_EVENTS_INLINE thread_local ThreadPool *ThreadPool::m_currentPool = nullptr;
+HLK_EVENTS_INLINE thread_local unsigned int ThreadPool::m_currentWorker = 0;
+
+HLK_EVENTS_INLINE ThreadPool::ThreadPool(unsigned int workers, const std::vector<int> &affinity) {
+    if (workers == 0) {
+        workers = std::thread::hardware_concurrency();
+    }
+    if (workers == 0) {
+        workers = 1;
+    }
+
+    m_workers.reserve(workers);
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned int i = 0; i < workers; ++i) {
+        m_workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+#ifdef __linux__
+        if (!affinity.empty()) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(affinity[i % affinity.size()], &cpus);
+            pthread_setaffinity_np(m_workers[i]->thread.native_handle(), sizeof(cpus), &cpus);
+        }
+#endif
+    }
+}
+
+HLK_EVENTS_INLINE ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    for (auto &worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+HLK_EVENTS_INLINE ThreadPool *ThreadPool::getInstance() {
+    std::unique_lock lock(m_instanceMutex);
+    if (!m_instance) {
+        m_instance = new ThreadPool(m_instanceWorkers, m_instanceAffinity);
+    }
+    return m_instance;
+}
+
+HLK_EVENTS_INLINE bool ThreadPool::configureInstance(unsigned int workers, const std::vector<int> &affinity) {
+    std::unique_lock lock(m_instanceMutex);
+    if (m_instance) {
+        return false;
+    }
+    m_instanceWorkers = workers;
+    m_instanceAffinity = affinity;
+    return true;
+}
+
+HLK_EVENTS_INLINE void ThreadPool::execute(Task &&task) {
+    // Keep tasks scheduled by a worker local to it
+    unsigned int index = m_currentPool == this
+        ? m_currentWorker
+        : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    {
+        std::unique_lock lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_pendingTasks.fetch_add(1);
+
+    // Synchronize with a worker which is about to sleep to not lose wakeup
+    { std::unique_lock lock(m_sleepMutex); }
+    m_wakeup.notify_one();
+}
+
+HLK_EVENTS_INLINE void ThreadPool::run(unsigned int index) {
+    m_currentPool = this;
+    m_currentWorker = index;
+
+    Task task;
+    for (;;) {
+        if (takeTask(index, task)) {
+            m_pendingTasks.fetch_sub(1);
+            task();
+            task.reset();
+            continue;
+        }
+
+        std::unique_lock lock(m_sleepMutex);
+        m_wakeup.wait(lock, [this] () {
+            return m_pendingTasks.load() != 0 || m_stopping;
+        });
+        // Remaining tasks are finished before stopping
+        if (m_stopping && m_pendingTasks.load() == 0) {
+            return;
+        }
+    }
+}
+
+HLK_EVENTS_INLINE bool ThreadPool::takeTask(unsigned int index, Task &task) {
+    // Newest task of own queue
+    {
+        Worker &worker = *m_workers[index];
+        std::unique_lock lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Oldest task of other queues
+    for (size_t i = 1; i < m_workers.size(); ++i) {
+        Worker &victim = *m_workers[(index + i) % m_workers.size()];
+        std::unique_lock lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Hlk
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_THREAD_POOL_H
+#define HLK_THREAD_POOL_H
+
+#include "abstractexecutor.h"
+#include "config.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hlk {
+
+/**
+ * @brief Work-stealing thread pool
+ * 
+ * Every worker owns a task queue. Tasks scheduled from a worker go to its own 
+ * queue and are taken in LIFO order, tasks scheduled from other threads are 
+ * distributed between the workers in round-robin. An idle worker steals the 
+ * oldest task from the other queues before going to sleep.
+ */
+class ThreadPool : public AbstractExecutor {
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    /**
+     * @param workers number of worker threads, 0 to use the number of 
+     * hardware threads
+     * @param affinity CPUs to pin the workers to, worker i is pinned to 
+     * affinity[i % affinity.size()]. Empty to not pin the workers
+     */
+    explicit ThreadPool(unsigned int workers = 0, const std::vector<int> &affinity = {});
+
+    ThreadPool(const ThreadPool &other) = delete;
+
+    // Waits for all scheduled tasks to finish
+    ~ThreadPool();
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    // Library-owned pool used by Event::emitAsync() by default
+    static ThreadPool *getInstance();
+
+    /**
+     * @brief Sets the parameters of the library-owned pool
+     * 
+     * @return false if the pool has already been created by getInstance()
+     */
+    static bool configureInstance(unsigned int workers, const std::vector<int> &affinity = {});
+
+    virtual void execute(Task &&task) override;
+
+    virtual unsigned int concurrency() const override { return workerCount(); }
+
+    unsigned int workerCount() const { return m_workers.size(); }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    ThreadPool& operator=(const ThreadPool &other) = delete;
+
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    void run(unsigned int index);
+    bool takeTask(unsigned int index, Task &task);
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    static std::mutex m_instanceMutex;
+    static ThreadPool *m_instance;
+    static unsigned int m_instanceWorkers;
+    static std::vector<int> m_instanceAffinity;
+
+    static thread_local ThreadPool *m_currentPool;
+    static thread_local unsigned int m_currentWorker;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned int> m_nextWorker = 0;
+    std::atomic<size_t> m_pendingTasks = 0;
+    std::atomic<bool> m_stopping = false;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+};
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "threadpool.cpp"
+#endif
+
+#endif // HLK_THREAD_POOL_H
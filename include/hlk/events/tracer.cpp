@@ -0,0 +1,233 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#include "tracer.h"
+
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+namespace Hlk {
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+
+HLK_EVENTS_INLINE std::atomic<bool> Tracer::m_recording { false };
+HLK_EVENTS_INLINE std::atomic<uint64_t> Tracer::m_dropped { 0 };
+HLK_EVENTS_INLINE std::mutex Tracer::m_buffersMutex;
+HLK_EVENTS_INLINE Tracer::Buffer *Tracer::m_buffers = nullptr;
+HLK_EVENTS_INLINE unsigned int Tracer::m_threads = 0;
+HLK_EVENTS_INLINE size_t Tracer::m_capacity = Tracer::defaultCapacity;
+HLK_EVENTS_INLINE Tracer::Clock::time_point Tracer::m_epoch;
+
+HLK_EVENTS_INLINE void Tracer::start(size_t capacity) {
+    std::unique_lock lock(m_buffersMutex);
+    unsafeStop();
+
+    // Nobody writes now, buffers of finished threads are no longer needed
+    Buffer **link = &m_buffers;
+    while (Buffer *buffer = *link) {
+        if (buffer->finished) {
+            *link = buffer->next;
+            delete buffer;
+            continue;
+        }
+        buffer->records.clear();
+        link = &buffer->next;
+    }
+
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_capacity = capacity;
+    m_epoch = Clock::now();
+    m_recording.store(true);
+}
+
+HLK_EVENTS_INLINE void Tracer::stop() {
+    std::unique_lock lock(m_buffersMutex);
+    unsafeStop();
+}
+
+HLK_EVENTS_INLINE bool Tracer::write(const std::string &path) {
+    std::unique_lock lock(m_buffersMutex);
+    unsafeStop();
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for (Buffer *buffer = m_buffers; buffer; buffer = buffer->next) {
+        if (buffer->records.empty()) {
+            continue;
+        }
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" 
+             << buffer->thread << ",\"args\":{\"name\":\"Thread " << buffer->thread << "\"}}";
+        first = false;
+        for (const Record &record : buffer->records) {
+            file << ",\n";
+            writeRecord(file, record, buffer->thread);
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":" 
+         << m_dropped.load(std::memory_order_relaxed) << "}}\n";
+
+    file.close();
+    return !file.fail();
+}
+
+HLK_EVENTS_INLINE void Tracer::record(Kind kind, const char *name, const void *event, const void *notifiable, 
+    Clock::time_point start, uint64_t duration) {
+    if (!isRecording()) {
+        return;
+    }
+
+    Buffer *buffer = threadBuffer();
+    buffer->busy.store(true);
+    if (m_recording.load()) {
+        if (buffer->records.size() < m_capacity) {
+            uint64_t offset = start > m_epoch 
+                ? std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_epoch).count() : 0;
+            buffer->records.push_back({ name, event, notifiable, offset, duration, kind });
+        } else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    buffer->busy.store(false, std::memory_order_release);
+}
+
+HLK_EVENTS_INLINE Tracer::Buffer *Tracer::threadBuffer() {
+    // Marks the buffer when its thread exits, the records stay until start()
+    struct Owner {
+        Buffer *buffer = nullptr;
+
+        ~Owner() {
+            if (buffer) {
+                std::unique_lock lock(m_buffersMutex);
+                buffer->finished = true;
+            }
+        }
+    };
+    thread_local Owner owner;
+
+    if (owner.buffer == nullptr) {
+        auto buffer = new Buffer();
+        std::unique_lock lock(m_buffersMutex);
+        buffer->thread = ++m_threads;
+        buffer->next = m_buffers;
+        m_buffers = buffer;
+        owner.buffer = buffer;
+    }
+    return owner.buffer;
+}
+
+HLK_EVENTS_INLINE void Tracer::unsafeStop() {
+    m_recording.store(false);
+    for (Buffer *buffer = m_buffers; buffer; buffer = buffer->next) {
+        while (buffer->busy.load()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+HLK_EVENTS_INLINE void Tracer::writeRecord(std::ostream &stream, const Record &record, unsigned int thread) {
+    const char *name = record.name && *record.name ? record.name : "Event";
+
+    stream << "{\"name\":";
+    switch (record.kind) {
+    case Kind::Emission:
+        writeString(stream, name);
+        stream << ",\"cat\":\"emission\",\"ph\":\"X\"";
+        break;
+    case Kind::Handler:
+        writeString(stream, (std::string(name) + " handler").c_str());
+        stream << ",\"cat\":\"handler\",\"ph\":\"X\"";
+        break;
+    case Kind::Attach:
+        stream << "\"attach\",\"cat\":\"dispatcher\",\"ph\":\"i\",\"s\":\"t\"";
+        break;
+    case Kind::Detach:
+        stream << "\"detach\",\"cat\":\"dispatcher\",\"ph\":\"i\",\"s\":\"t\"";
+        break;
+    case Kind::NotifiableDestroyed:
+        stream << "\"notifiable destroyed\",\"cat\":\"dispatcher\",\"ph\":\"X\"";
+        break;
+    }
+
+    stream << ",\"ts\":";
+    writeMicroseconds(stream, record.start);
+    if (record.kind != Kind::Attach && record.kind != Kind::Detach) {
+        stream << ",\"dur\":";
+        writeMicroseconds(stream, record.duration);
+    }
+    stream << ",\"pid\":1,\"tid\":" << thread << ",\"args\":{";
+
+    const char *separator = "";
+    if (record.event) {
+        stream << "\"event\":\"" << record.event << '"';
+        separator = ",";
+    }
+    if (record.name && *record.name && record.kind != Kind::Emission && record.kind != Kind::Handler) {
+        stream << ",\"name\":";
+        writeString(stream, record.name);
+    }
+    if (record.notifiable) {
+        stream << separator << "\"notifiable\":\"" << record.notifiable << '"';
+    }
+    stream << "}}";
+}
+
+HLK_EVENTS_INLINE void Tracer::writeString(std::ostream &stream, const char *string) {
+    stream << '"';
+    for (const char *c = string; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            stream << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(*c) 
+                   << std::dec << std::setfill(' ');
+        } else {
+            stream << *c;
+        }
+    }
+    stream << '"';
+}
+
+HLK_EVENTS_INLINE void Tracer::writeMicroseconds(std::ostream &stream, uint64_t nanoseconds) {
+    stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 
+           << std::setfill(' ');
+}
+
+#else
+
+HLK_EVENTS_INLINE void Tracer::start(size_t) { }
+
+HLK_EVENTS_INLINE void Tracer::stop() { }
+
+HLK_EVENTS_INLINE bool Tracer::write(const std::string &) {
+    return false;
+}
+
+HLK_EVENTS_INLINE void Tracer::record(Kind, const char *, const void *, const void *, Clock::time_point, uint64_t) { }
+
+#endif // HLK_EVENTS_INSTRUMENTATION
+
+} // namespace Hlk
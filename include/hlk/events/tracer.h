@@ -0,0 +1,177 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+
+#ifndef HLK_TRACER_H
+#define HLK_TRACER_H
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace Hlk {
+
+/**
+ * @brief Timeline of emissions in the Chrome Trace Event format
+ * 
+ * Available with instrumentation enabled, see instrumentation.h. Between 
+ * start() and stop() every emission, handler call and teardown of a 
+ * notifiable object is recorded as a span, attaching and detaching handlers 
+ * of notifiable objects as instant events. Each thread appends to its own 
+ * buffer without locking, write() saves the buffers as JSON which 
+ * chrome://tracing and Perfetto load, one track per thread. Spans nest, so 
+ * a handler emitting another event shows the cascade under its own span. 
+ * Events are shown by the names given with Event::setName().
+ */
+class Tracer {
+public:
+    /**************************************************************************
+     * Types
+     *************************************************************************/
+
+    enum class Kind : uint8_t {
+        Emission,
+        Handler,
+        Attach,
+        Detach,
+        NotifiableDestroyed
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    /**************************************************************************
+     * Constants
+     *************************************************************************/
+
+    static constexpr size_t defaultCapacity = 1 << 20;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    /**
+     * @brief Discards the previous records and starts recording
+     * 
+     * @param capacity records kept per thread, later ones are dropped and 
+     * counted
+     */
+    static void start(size_t capacity = defaultCapacity);
+
+    // Stops recording, returns when no thread is writing a record anymore
+    static void stop();
+
+    static bool isRecording() {
+#ifdef HLK_EVENTS_INSTRUMENTATION
+        return m_recording.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Stops recording and writes the records to a JSON file
+     * 
+     * @return false if the file can't be written or instrumentation is 
+     * disabled
+     */
+    static bool write(const std::string &path);
+
+    /**
+     * @brief Records a span or, with zero duration, an instant event
+     * 
+     * Called by the library while isRecording() is true.
+     * 
+     * @param name name of the event, nullptr if it has none
+     * @param event the event or nullptr
+     * @param notifiable the notifiable object or nullptr
+     */
+    static void record(Kind kind, const char *name, const void *event, const void *notifiable, 
+        Clock::time_point start, uint64_t duration = 0);
+
+#ifdef HLK_EVENTS_INSTRUMENTATION
+protected:
+    /**************************************************************************
+     * Types (Protected)
+     *************************************************************************/
+
+    struct Record {
+        const char *name;
+        const void *event;
+        const void *notifiable;
+        uint64_t start;
+        uint64_t duration;
+        Kind kind;
+    };
+
+    /* Written by its thread only. A thread sets busy before it checks that 
+    the tracer records and clears it after appending, so stop() waits for 
+    the records being written and afterwards the buffers may be read */
+    struct Buffer {
+        std::deque<Record> records;
+        std::atomic<bool> busy { false };
+        bool finished = false;
+        unsigned int thread = 0;
+        Buffer *next = nullptr;
+    };
+
+    /**************************************************************************
+     * Methods (Protected)
+     *************************************************************************/
+
+    // Buffer of the calling thread, registered on first use
+    static Buffer *threadBuffer();
+
+    // Stops recording, m_buffersMutex must be locked
+    static void unsafeStop();
+
+    // JSON of a record on the track of the thread
+    static void writeRecord(std::ostream &stream, const Record &record, unsigned int thread);
+    static void writeString(std::ostream &stream, const char *string);
+    static void writeMicroseconds(std::ostream &stream, uint64_t nanoseconds);
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    static std::atomic<bool> m_recording;
+    static std::atomic<uint64_t> m_dropped;
+    static std::mutex m_buffersMutex;
+    static Buffer *m_buffers;
+    static unsigned int m_threads;
+    static size_t m_capacity;
+    static Clock::time_point m_epoch;
+#endif
+};
+
+} // namespace Hlk
+
+#ifdef HLK_EVENTS_HEADER_ONLY
+#include "tracer.cpp"
+#endif
+
+#endif // HLK_TRACER_H
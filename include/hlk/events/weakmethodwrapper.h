@@ -0,0 +1,131 @@
+/******************************************************************************
+ * 
+ * Copyright (C) 2021 Dmitry Plastinin
+ * Contact: uncellon@yandex.ru, uncellon@gmail.com, uncellon@mail.ru
+ * 
+ * This file is part of the Hlk Events library.
+ * 
+ * Hlk Events is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as pubblished by the
+ * Free Software Foundation, either version 3 of the License, or (at your 
+ * option) any later version.
+ * 
+ * Hlk Events is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or 
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser Public License for more
+ * details
+ * 
+ * You should have received a copy of the GNU Lesset General Public License
+ * along with Hlk Events. If not, see <https://www.gnu.org/licenses/>.
+ * 
+ *****************************************************************************/
+#ifndef HLK_WEAK_METHOD_WRAPPER_H
+#define HLK_WEAK_METHOD_WRAPPER_H
+
+#include "abstractwrapper.h"
+
+#include <memory>
+
+namespace Hlk {
+
+template<class TClass, class TFunction>
+class WeakMethodWrapper;
+
+/**
+ * @brief Method of an object owned by std::shared_ptr, held by a weak reference
+ * 
+ * The object is locked for the duration of each call, so it can't be 
+ * destroyed while its method runs. Once it is gone expired() is true and a 
+ * call does nothing, returning a value-initialized TReturn like an empty 
+ * Delegate. Wrappers are equal if they refer to the same object and method.
+ */
+template<class TReturn, class TClass, class... TArgs>
+class WeakMethodWrapper<TClass, TReturn(TArgs...)> : public AbstractWrapper<TReturn(TArgs...)> {
+    using TWMWrapper = WeakMethodWrapper<TClass, TReturn(TArgs...)>;
+public:
+    /**************************************************************************
+     * Constructors / Destructors
+     *************************************************************************/
+
+    WeakMethodWrapper() = default;
+
+    // Auto-bind constructor
+    WeakMethodWrapper(const std::weak_ptr<TClass> &object, TReturn (TClass::*method)(TArgs...)) {
+        bind(object, method);
+    }
+
+    WeakMethodWrapper(const WeakMethodWrapper &other) = default;
+    WeakMethodWrapper(WeakMethodWrapper && other) noexcept = default;
+
+    virtual ~WeakMethodWrapper() = default;
+
+    /**************************************************************************
+     * Methods
+     *************************************************************************/
+
+    virtual AbstractWrapper<TReturn(TArgs...)> *clone(void *storage) const override {
+        return this->template emplace<TWMWrapper>(storage, *this);
+    }
+
+    virtual AbstractWrapper<TReturn(TArgs...)> *move(void *storage) override {
+        return this->template relocate<TWMWrapper>(storage, *this);
+    }
+
+    virtual void destroy() override {
+        this->template dispose<TWMWrapper>(this);
+    }
+
+    virtual bool expired() const override {
+        return m_object.expired();
+    }
+
+    void bind(const std::weak_ptr<TClass> &object, TReturn (TClass::*method)(TArgs...)) {
+        m_object = object;
+        m_pointer = object.lock().get();
+        m_method = method;
+        this->m_tag = this->template typeTag<TWMWrapper>();
+        this->m_hash = this->hashBytes(&m_method, sizeof(m_method),
+            this->hashBytes(&m_pointer, sizeof(m_pointer), reinterpret_cast<std::size_t>(this->m_tag)));
+    }
+
+    /**************************************************************************
+     * Overloaded operators
+     *************************************************************************/
+
+    virtual TReturn operator()(TArgs&&... args) override {
+        std::shared_ptr<TClass> object = m_object.lock();
+        if (!object) {
+            return TReturn();
+        }
+        return (object.get()->*m_method)(std::forward<TArgs>(args)...);
+    }
+
+    WeakMethodWrapper& operator=(const WeakMethodWrapper &other) = default;
+    WeakMethodWrapper& operator=(WeakMethodWrapper&& other) = default;
+
+protected:
+    /**************************************************************************
+     * Method (Protected)
+     *************************************************************************/
+
+    // Objects sharing an address, e.g. a new one in the memory of an expired one, differ by their owner
+    virtual bool isEquals(const AbstractWrapper<TReturn(TArgs...)> &other) const override {
+        const TWMWrapper &otherWrapper = static_cast<const TWMWrapper &>(other);
+        return m_pointer == otherWrapper.m_pointer && m_method == otherWrapper.m_method
+            && !m_object.owner_before(otherWrapper.m_object) && !otherWrapper.m_object.owner_before(m_object);
+    }
+
+    /**************************************************************************
+     * Members
+     *************************************************************************/
+
+    std::weak_ptr<TClass> m_object;
+
+    // Identifies the object in comparisons, never dereferenced
+    TClass *m_pointer = nullptr;
+    TReturn (TClass::*m_method)(TArgs...) = nullptr;
+};
+
+} // namespace Hlk
+
+#endif // HLK_WEAK_METHOD_WRAPPER_H
@@ -0,0 +1,125 @@
+#include <hlk/events/concurrentevent.h>
+#include <hlk/events/event.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int copies = 0;
+unsigned int counter = 0;
+
+class Payload {
+public:
+    Payload() = default;
+    Payload(const Payload &other) { ++copies; }
+    Payload(Payload &&other) = default;
+};
+
+// Executor that runs tasks only when asked to
+class ManualExecutor : public AbstractExecutor {
+public:
+    virtual void execute(Task &&task) override {
+        m_tasks.push_back(std::move(task));
+    }
+
+    void runAll() {
+        for (auto &task : m_tasks) {
+            task();
+        }
+        m_tasks.clear();
+    }
+
+protected:
+    std::vector<Task> m_tasks;
+};
+
+int main(int argc, char *argv[]) {
+    // Delegates forward the argument they got
+    Delegate<void(Payload)> delegate([] (Payload payload) { ++counter; });
+    delegate(Payload());
+    if (copies != 0 || counter != 1) {
+        return 1;
+    }
+
+    // One copy per handler taking the argument by value
+    Event<Payload> event;
+    event.addEventHandler([] (Payload payload) { ++counter; });
+    event.addEventHandler([] (Payload payload) { counter += 10; });
+    event.addEventHandler([] (Payload payload) { counter += 100; });
+    copies = counter = 0;
+    event(Payload());
+    if (copies != 3 || counter != 111) {
+        return 1;
+    }
+
+    // The last handler gets the argument itself
+    copies = counter = 0;
+    event.emitMove(Payload());
+    if (copies != 2 || counter != 111) {
+        return 1;
+    }
+
+    // References are passed through
+    Event<const Payload &> referenceEvent;
+    referenceEvent.addEventHandler([] (const Payload &payload) { ++counter; });
+    referenceEvent.addEventHandler([] (const Payload &payload) { ++counter; });
+    Payload payload;
+    copies = counter = 0;
+    referenceEvent(payload);
+    if (copies != 0 || counter != 2) {
+        return 1;
+    }
+
+    // Move-only arguments, synchronous and asynchronous
+    ManualExecutor executor;
+    Event<std::unique_ptr<int>> ownershipEvent;
+    ownershipEvent.setExecutor(&executor);
+    ownershipEvent.addEventHandler([] (std::unique_ptr<int> value) { counter += *value; });
+    counter = 0;
+    ownershipEvent(std::make_unique<int>(1));
+    ownershipEvent.emitMove(std::make_unique<int>(10));
+    ownershipEvent.emitAsync(std::make_unique<int>(100));
+    executor.runAll();
+    if (counter != 111) {
+        return 1;
+    }
+
+    // Every handler may look at a move-only argument taken by reference
+    Event<std::unique_ptr<int> &&> referenceOwnershipEvent;
+    referenceOwnershipEvent.addEventHandler([] (std::unique_ptr<int> &&value) { counter += *value; });
+    referenceOwnershipEvent.addEventHandler([] (std::unique_ptr<int> &&value) {
+        std::unique_ptr<int> owner = std::move(value);
+        counter += *owner;
+    });
+    counter = 0;
+    referenceOwnershipEvent(std::make_unique<int>(5));
+    if (counter != 10) {
+        return 1;
+    }
+
+    // Handlers attached by the last handler don't get the moved argument
+    Event<Payload> growingEvent;
+    growingEvent.addEventHandler([&growingEvent] (Payload payload) {
+        ++counter;
+        growingEvent.addEventHandler([] (Payload payload) { counter += 10; });
+    });
+    counter = 0;
+    growingEvent.emitMove(Payload());
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Concurrent event follows the same rules
+    ConcurrentEvent<Payload> concurrentEvent;
+    concurrentEvent.addEventHandler([] (Payload payload) { ++counter; });
+    concurrentEvent.addEventHandler([] (Payload payload) { ++counter; });
+    copies = counter = 0;
+    concurrentEvent(Payload());
+    concurrentEvent.emitMove(Payload());
+    if (copies != 3 || counter != 4) {
+        return 1;
+    }
+
+    return 0;
+}
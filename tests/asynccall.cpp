@@ -0,0 +1,97 @@
+#include <hlk/events/event.h>
+#include <hlk/events/threadpool.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+std::atomic<unsigned int> counter = 0;
+
+// Executor that runs tasks only when asked to
+class ManualExecutor : public AbstractExecutor {
+public:
+    virtual void execute(Task &&task) override {
+        m_tasks.push_back(std::move(task));
+    }
+
+    void runAll() {
+        for (auto &task : m_tasks) {
+            task();
+        }
+        m_tasks.clear();
+    }
+
+protected:
+    std::vector<Task> m_tasks;
+};
+
+bool waitCounter(unsigned int value) {
+    for (int i = 0; i < 5000 && counter != value; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return counter == value;
+}
+
+int main(int argc, char *argv[]) {
+    // Library-owned pool, handlers run on worker threads
+    ThreadPool::configureInstance(2);
+    if (ThreadPool::getInstance()->workerCount() != 2) {
+        return 1;
+    }
+
+    Event<const std::string &> event;
+    std::atomic<bool> onCallerThread = false;
+    std::thread::id caller = std::this_thread::get_id();
+    event.addEventHandler([&onCallerThread, caller] (const std::string &message) {
+        if (std::this_thread::get_id() == caller) {
+            onCallerThread = true;
+        }
+        counter += message.size();
+    });
+    for (int i = 0; i < 100; ++i) {
+        event(std::string("message"), true);
+    }
+    event.emitAsync("message");
+    if (!waitCounter(707) || onCallerThread) {
+        return 1;
+    }
+
+    // Custom executor
+    ManualExecutor executor;
+    auto delayed = new Event<int>();
+    delayed->setExecutor(&executor);
+    delayed->addEventHandler([] (int value) { counter += value; });
+    delayed->emitAsync(3);
+    if (counter != 707) {
+        return 1;
+    }
+    executor.runAll();
+    if (counter != 710) {
+        return 1;
+    }
+
+    // Emission scheduled before the event was destroyed is dropped
+    delayed->emitAsync(3);
+    delete delayed;
+    executor.runAll();
+    if (counter != 710) {
+        return 1;
+    }
+
+    // Own pool with pinned workers
+    {
+        ThreadPool pool(4, { 0 });
+        for (int i = 0; i < 1000; ++i) {
+            pool.execute([] () { ++counter; });
+        }
+    }
+    if (counter != 1710) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+    void destroySelf() { delete this; }
+};
+
+int main(int argc, char *argv[]) {
+    // Many handlers on several events, destroyed in mixed order
+    auto first = new Event<>();
+    auto second = new Event<>();
+    std::vector<Handler *> handlers;
+    for (int i = 0; i < 100; ++i) {
+        auto handler = new Handler();
+        first->addEventHandler(handler, &Handler::increaseCounter);
+        second->addEventHandler(handler, &Handler::increaseCounter);
+        handlers.push_back(handler);
+    }
+    for (size_t i = 0; i < handlers.size(); i += 2) {
+        delete handlers[i];
+    }
+    (*first)();
+    (*second)();
+    if (counter != 100) {
+        return 1;
+    }
+    delete first;
+    for (size_t i = 1; i < handlers.size(); i += 2) {
+        delete handlers[i];
+    }
+    (*second)();
+    if (counter != 100) {
+        return 1;
+    }
+    delete second;
+
+    // Handler destroying its own object during emission
+    Event<> event;
+    auto selfDestroying = new Handler();
+    event.addEventHandler(selfDestroying, &Handler::destroySelf);
+    event();
+    event();
+
+    // Attachments follow a moved event
+    auto handler = new Handler();
+    Event<> source;
+    source.addEventHandler(handler, &Handler::increaseCounter);
+    Event<> moved(std::move(source));
+    moved();
+    delete handler;
+    moved();
+    source();
+    if (counter != 101) {
+        return 1;
+    }
+
+    // Independent objects are torn down in parallel
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([] () {
+            for (int j = 0; j < 1000; ++j) {
+                Event<> local;
+                Handler handler;
+                local.addEventHandler(&handler, &Handler::increaseCounter);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace Hlk;
+
+struct Tick {
+    int price;
+};
+
+std::vector<std::string> calls;
+int total = 0;
+
+void sumBatch(Span<const Tick> ticks) {
+    for (const Tick &tick : ticks) {
+        total += tick.price;
+    }
+    calls.push_back("batch " + std::to_string(ticks.size()));
+}
+
+class Handler : public NotifiableObject {
+public:
+    void onTicks(Span<const Tick> ticks) { calls.push_back("method " + std::to_string(ticks.size())); }
+};
+
+int main(int argc, char *argv[]) {
+    Event<const Tick &> event;
+    event.addEventHandler([] (const Tick &tick) { calls.push_back("item " + std::to_string(tick.price)); });
+    Connection batchConnection = event.addBatchHandler(sumBatch);
+
+    // Per-item handlers get every item before the next handler is called
+    std::vector<Tick> ticks { { 1 }, { 2 }, { 3 } };
+    event.emitBatch(ticks);
+    if (calls != std::vector<std::string> { "item 1", "item 2", "item 3", "batch 3" } || total != 6) {
+        return 1;
+    }
+
+    // Single emission reaches batch handlers as a batch of one
+    calls.clear();
+    event(Tick { 10 });
+    if (calls != std::vector<std::string> { "item 10", "batch 1" } || total != 16) {
+        return 1;
+    }
+
+    // Duplicates are detected, batch handlers are removed by connection
+    if (event.addBatchHandler(sumBatch) != batchConnection) {
+        return 1;
+    }
+    event.removeEventHandler(batchConnection);
+    calls.clear();
+    std::array<Tick, 2> array { { { 4 }, { 5 } } };
+    event.emitBatch(array);
+    if (calls != std::vector<std::string> { "item 4", "item 5" } || total != 16) {
+        return 1;
+    }
+
+    // Method batch handler is removed with its object
+    auto handler = new Handler();
+    event.addBatchHandler(handler, &Handler::onTicks);
+    calls.clear();
+    event.emitBatch(Span<const Tick>(ticks.data(), 2));
+    delete handler;
+    event.emitBatch(ticks);
+    if (calls.size() != 6 || calls[2] != "method 2") {
+        return 1;
+    }
+
+    // Temporary and const containers
+    calls.clear();
+    event.emitBatch(std::vector<Tick> { { 7 }, { 8 } });
+    const std::vector<Tick> constTicks { { 9 } };
+    event.emitBatch(constTicks);
+    if (calls != std::vector<std::string> { "item 7", "item 8", "item 9" }) {
+        return 1;
+    }
+
+    // Several arguments are batched as tuples
+    Event<int, std::string> pairEvent;
+    std::string joined;
+    pairEvent.addEventHandler([&joined] (int number, std::string text) { joined += std::to_string(number) + text; });
+    pairEvent.addBatchHandler([&joined] (Span<const std::tuple<int, std::string>> batch) {
+        joined += "|" + std::to_string(batch.size());
+    });
+    std::vector<std::tuple<int, std::string>> pairs { { 1, "a" }, { 2, "b" } };
+    pairEvent.emitBatch(pairs);
+    pairEvent(3, "c");
+    if (joined != "1a2b|23c|1") {
+        return 1;
+    }
+
+    return 0;
+}
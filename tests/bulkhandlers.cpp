@@ -0,0 +1,93 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <memory>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+void increaseCounter() { ++counter; }
+void addTen() { counter += 10; }
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+int main(int argc, char *argv[]) {
+    constexpr size_t count = 10000;
+    std::vector<std::unique_ptr<Handler>> owners;
+    std::vector<Handler *> objects;
+    for (size_t i = 0; i < count; ++i) {
+        owners.push_back(std::make_unique<Handler>());
+        objects.push_back(owners.back().get());
+    }
+
+    // Objects attached in bulk, repeated ones keep their connection
+    Event<> event;
+    std::vector<Connection> connections = event.addEventHandlers(objects, &Handler::increaseCounter);
+    if (event.addEventHandlers(objects, &Handler::increaseCounter) != connections) {
+        return 1;
+    }
+    event();
+    if (counter != count) {
+        return 1;
+    }
+
+    // Half of the objects removed by value, a quarter by connection
+    std::vector<Handler *> half(objects.begin(), objects.begin() + count / 2);
+    event.removeEventHandlers(half, &Handler::increaseCounter);
+    event.removeEventHandlers(std::vector<Connection>(connections.begin() + count / 2, connections.begin() + count / 4 * 3));
+    counter = 0;
+    event();
+    if (counter != count / 4) {
+        return 1;
+    }
+
+    // Functions in bulk, a duplicate in the range is attached once
+    std::vector<void (*)()> functions { increaseCounter, addTen, increaseCounter };
+    connections = event.addEventHandlers(functions);
+    if (connections[0] != connections[2]) {
+        return 1;
+    }
+    counter = 0;
+    event();
+    if (counter != count / 4 + 11) {
+        return 1;
+    }
+
+    // Cleared event detaches the remaining objects
+    event.clear();
+    owners.clear();
+    counter = 0;
+    event();
+    if (counter != 0) {
+        return 1;
+    }
+
+    // Assignment of an empty event removes every handler
+    for (size_t i = 0; i < 6; ++i) {
+        event.addEventHandler([i] () { counter += i + 1; });
+    }
+    event = Event<>();
+    event();
+    if (counter != 0) {
+        return 1;
+    }
+
+    // Handler clearing its event during emission
+    event.addEventHandler([&event] () {
+        ++counter;
+        event.clear();
+    });
+    event.addEventHandler(addTen);
+    event();
+    event();
+    if (counter != 1) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <hlk/events/concurrentevent.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+std::atomic<unsigned int> counter = 0;
+
+void increaseCounter(int value) { counter += value; }
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter(int value) { counter += value; }
+};
+
+class Holder {
+public:
+    ConcurrentEvent<int> onTriggered;
+};
+
+int main(int argc, char *argv[]) {
+    // Concurrent emission while handlers are added and removed
+    ConcurrentEvent<int> event;
+    std::atomic<bool> running = true;
+    std::vector<std::thread> emitters;
+    for (int i = 0; i < 4; ++i) {
+        emitters.emplace_back([&event, &running] () {
+            while (running) {
+                event(1);
+            }
+        });
+    }
+    std::vector<Handler *> handlers;
+    for (int i = 0; i < 1000; ++i) {
+        auto handler = new Handler();
+        event.addEventHandler(handler, &Handler::increaseCounter);
+        event.addEventHandler(increaseCounter);
+        event.removeEventHandler(increaseCounter);
+        if (i % 2) {
+            event.removeEventHandler(handler, &Handler::increaseCounter);
+        }
+        handlers.push_back(handler);
+    }
+    running = false;
+    for (auto &emitter : emitters) {
+        emitter.join();
+    }
+
+    // Remaining method handlers are removed on handler destruction
+    for (auto handler : handlers) {
+        delete handler;
+    }
+    counter = 0;
+    event(1);
+    if (counter != 0) {
+        return 1;
+    }
+
+    // Duplicate handlers are ignored
+    event.addEventHandler(increaseCounter);
+    event.addEventHandler(increaseCounter);
+    event(1);
+    if (counter != 1) {
+        return 1;
+    }
+    event.removeEventHandler(increaseCounter);
+
+    // Handler destroying the event during emission
+    auto holder = new Holder();
+    holder->onTriggered.addEventHandler([holder] (int value) {
+        delete holder;
+    });
+    holder->onTriggered.addEventHandler(increaseCounter);
+    holder->onTriggered(1);
+    if (counter != 2) {
+        return 1;
+    }
+
+    // Object destroyed by another thread while an emission is running
+    ConcurrentEvent<int> blocking;
+    std::atomic<bool> started = false;
+    std::atomic<bool> destroyed = false;
+    blocking.addEventHandler([&started, &destroyed] (int) {
+        started = true;
+        while (!destroyed) {
+            std::this_thread::yield();
+        }
+    });
+    auto handler = new Handler();
+    blocking.addEventHandler(handler, &Handler::increaseCounter);
+    std::thread emitter([&blocking] () { blocking(1); });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    delete handler;
+    destroyed = true;
+    emitter.join();
+    if (counter != 2) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+void increaseCounter() { ++counter; }
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+int main(int argc, char *argv[]) {
+    Event<> event;
+
+    // Lambdas are removed by their connection
+    Connection first = event.addEventHandler([] () { ++counter; });
+    Connection second = event.addEventHandler([] () { counter += 10; });
+    event();
+    event.removeEventHandler(first);
+    event();
+    if (counter != 21) {
+        return 1;
+    }
+
+    // Stale connection doesn't match the handler reusing its slot
+    Connection third = event.addEventHandler(increaseCounter);
+    event.removeEventHandler(first);
+    event();
+    if (counter != 32 || third.index() != first.index() || third == first) {
+        return 1;
+    }
+
+    // Duplicate subscription returns the existing connection
+    if (event.addEventHandler(increaseCounter) != third) {
+        return 1;
+    }
+
+    // Method handler removed by connection is detached from its object
+    auto handler = new Handler();
+    Connection method = event.addEventHandler(handler, &Handler::increaseCounter);
+    event.removeEventHandler(method);
+    delete handler;
+    event.removeEventHandler(second);
+    event.removeEventHandler(third);
+    event();
+    if (counter != 32) {
+        return 1;
+    }
+
+    // Handler removing itself and a later handler during emission
+    Connection self, later;
+    self = event.addEventHandler([&event, &self, &later] () {
+        ++counter;
+        event.removeEventHandler(self);
+        event.removeEventHandler(later);
+    });
+    later = event.addEventHandler([] () { counter += 100; });
+    event();
+    event();
+    if (counter != 33) {
+        return 1;
+    }
+
+    // Handler attached during emission is called from the next emission
+    event.addEventHandler([&event] () {
+        event.addEventHandler([] () { counter += 1000; });
+    });
+    event();
+    if (counter != 33) {
+        return 1;
+    }
+    event();
+    if (counter != 1033) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <hlk/events/coroutines.h>
+#include <hlk/events/event.h>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+// Eager coroutine owned by the caller, destroyed with the task
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) { }
+    Task(const Task &other) = delete;
+    ~Task() { m_handle.destroy(); }
+
+    bool done() const { return m_handle.done(); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+std::vector<int> received;
+
+Task waitThree(Event<int, const std::string &> &event) {
+    for (int i = 0; i < 3; ++i) {
+        auto [value, text] = co_await event.next();
+        received.push_back(value + int(text.size()));
+    }
+}
+
+Task waitForever(Event<int> &event) {
+    co_await event.next();
+    received.push_back(-1);
+}
+
+std::atomic<int> resumed = 0;
+
+Task waitOnce(Event<int> &event) {
+    co_await event.next();
+    ++resumed;
+}
+
+Task consume(Event<int> &event) {
+    auto stream = event.emissions();
+    event(1);
+    event(2);
+    while (auto args = co_await stream.next()) {
+        received.push_back(std::get<0>(*args));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Every wait gets its own emission, including waits resumed by emission
+    Event<int, const std::string &> event;
+    {
+        Task task = waitThree(event);
+        event(10, "a");
+        event(20, "bb");
+        if (task.done() || received != std::vector<int> { 11, 22 }) {
+            return 1;
+        }
+        event(30, "ccc");
+        if (!task.done() || received.back() != 33) {
+            return 1;
+        }
+    }
+
+    // Destroyed coroutine removes its handler
+    received.clear();
+    Event<int> simpleEvent;
+    {
+        Task task = waitForever(simpleEvent);
+    }
+    simpleEvent(1);
+    if (!received.empty()) {
+        return 1;
+    }
+
+    // Coroutine outliving the event stays suspended and is destroyed safely
+    {
+        auto temporary = std::make_unique<Event<int>>();
+        Task task = waitForever(*temporary);
+        temporary.reset();
+        if (task.done()) {
+            return 1;
+        }
+    }
+
+    // Concurrent emissions resume the coroutine once, the losing one never touches the destroyed awaiter
+    for (int round = 0; round < 200; ++round) {
+        Event<int> concurrent;
+        Task task = waitOnce(concurrent);
+        std::atomic<bool> start = false;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 2; ++i) {
+            threads.emplace_back([&concurrent, &start] () {
+                while (!start) { }
+                concurrent(1);
+            });
+        }
+        start = true;
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        if (!task.done() || resumed != round + 1) {
+            return 1;
+        }
+    }
+
+    // Stream collects emissions and ends with the event
+    {
+        auto temporary = std::make_unique<Event<int>>();
+        Task task = consume(*temporary);
+        (*temporary)(3);
+        if (task.done() || received != std::vector<int> { 1, 2, 3 }) {
+            return 1;
+        }
+        temporary.reset();
+        if (!task.done()) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <hlk/events/event.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+void increaseCounter() { ++counter; }
+void decreaseCounter() { --counter; }
+
+class Handler {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+int main(int argc, char *argv[]) {
+    Handler handler;
+    int step = 1;
+    auto stateless = [] () { ++counter; };
+    auto capturing = [&step] () { counter += step; };
+    std::string text = "text";
+    auto opaque = [text] () { counter += text.size(); };
+
+    // Same targets are equal and hash equally, different targets are not
+    if (Delegate<void()>(increaseCounter) != Delegate<void()>(increaseCounter)
+        || Delegate<void()>(increaseCounter) == Delegate<void()>(decreaseCounter)
+        || Delegate<void()>(&handler, &Handler::increaseCounter) != Delegate<void()>(&handler, &Handler::increaseCounter)
+        || Delegate<void()>(stateless) != Delegate<void()>(stateless)
+        || Delegate<void()>(capturing) != Delegate<void()>(capturing)
+        || Delegate<void()>(increaseCounter).hash() != Delegate<void()>(increaseCounter).hash()
+        || Delegate<void()>(capturing).hash() != Delegate<void()>(capturing).hash()) {
+        return 1;
+    }
+
+    // Lambdas with padded or non-trivial captures are only equal to themselves
+    Delegate<void()> opaqueDelegate(opaque);
+    if (opaqueDelegate != opaqueDelegate || opaqueDelegate == Delegate<void()>(opaque)) {
+        return 1;
+    }
+
+    // Empty delegates are equal only to each other
+    if (Delegate<void()>() != Delegate<void()>() || Delegate<void()>() == Delegate<void()>(increaseCounter)) {
+        return 1;
+    }
+
+    std::unordered_set<Delegate<void()>> delegates;
+    delegates.insert(increaseCounter);
+    delegates.insert(increaseCounter);
+    delegates.insert(stateless);
+    delegates.insert(Delegate<void()>(&handler, &Handler::increaseCounter));
+    if (delegates.size() != 3 || !delegates.count(stateless)) {
+        return 1;
+    }
+
+    // Duplicate detection and removal by value past the index threshold
+    Event<int> event;
+    auto make = [] (int i) { return [i] (int value) { counter += value + i; }; };
+    std::vector<Connection> connections;
+    for (int i = 0; i < 100; ++i) {
+        connections.push_back(event.addEventHandler(make(i)));
+    }
+    for (int i = 0; i < 100; ++i) {
+        if (event.addEventHandler(make(i)) != connections[i]) {
+            return 1;
+        }
+    }
+    auto same = [&step] (int value) { counter += value * step; };
+    Connection sameConnection = event.addEventHandler(same);
+    if (event.addEventHandler(same) != sameConnection) {
+        return 1;
+    }
+    event.removeEventHandler(same);
+    for (int i = 0; i < 50; ++i) {
+        event.removeEventHandler(make(i));
+    }
+    counter = 0;
+    event(1);
+    if (counter != 50 + (50 + 99) * 50 / 2) {
+        return 1;
+    }
+
+    return 0;
+}
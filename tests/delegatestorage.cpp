@@ -0,0 +1,47 @@
+#include <hlk/events/delegate.h>
+
+#include <array>
+#include <utility>
+
+using namespace Hlk;
+
+int main(int argc, char *argv[]) {
+    int sum = 0;
+
+    // Small capture is placed into the inline storage
+    Delegate<void(int)> small([&sum] (int value) { sum += value; });
+    if (!small.isInline()) {
+        return 1;
+    }
+
+    // Large capture falls back to the heap
+    std::array<int, 64> values {};
+    values[0] = 10;
+    Delegate<void(int)> large([&sum, values] (int value) { sum += value + values[0]; });
+    if (large.isInline()) {
+        return 1;
+    }
+
+    // Copies and moves keep the wrapper callable
+    Delegate<void(int)> smallCopy(small);
+    Delegate<void(int)> largeCopy(large);
+    Delegate<void(int)> smallMoved(std::move(small));
+    Delegate<void(int)> largeMoved;
+    largeMoved = std::move(large);
+    smallCopy(1);
+    largeCopy(1);
+    smallMoved(1);
+    largeMoved(1);
+    if (sum != 24) {
+        return 1;
+    }
+
+    // Rebinding destroys the previous wrapper
+    smallCopy = largeCopy;
+    smallCopy(0);
+    if (sum != 34 || smallCopy.isInline()) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <hlk/events/eventbus.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <memory>
+#include <string>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter(int value) { counter += value; }
+};
+
+int main(int argc, char *argv[]) {
+    // `*` is one segment, `#` any number of them
+    if (!EventBus<>::matches("md.*.AAPL.#", "md.nyse.AAPL") || !EventBus<>::matches("md.*.AAPL.#", "md.nyse.AAPL.t.1")
+        || EventBus<>::matches("md.*.AAPL.#", "md.AAPL") || !EventBus<>::matches("#.trade", "trade")
+        || !EventBus<>::matches("#", "") || EventBus<>::matches("md.*", "md.nyse.AAPL")) {
+        return 1;
+    }
+
+    // Exact and wildcard patterns
+    EventBus<int> bus;
+    bus.addEventHandler("md.nyse.AAPL.trade", [] (int value) { counter += value; });
+    bus.addEventHandler("md.*.AAPL.#", [] (int value) { counter += 10 * value; });
+    bus.addEventHandler("md.#.trade", [] (int value) { counter += 100 * value; });
+    bus.addEventHandler("md.*", [] (int value) { counter += 1000 * value; });
+    bus.publish("md.nyse.AAPL.trade", 1);
+    if (counter != 111) {
+        return 1;
+    }
+    counter = 0;
+    bus.publish("md.nyse.AAPL", 1);
+    bus.publish("md.nyse", 1);
+    bus.publish("fx.EUR", 1);
+    if (counter != 1010) {
+        return 1;
+    }
+
+    // A new pattern is found by already published topics, handles skip the lookup
+    EventBus<int>::Topic topic = bus.topic("md.nyse.AAPL.trade");
+    Handler *handler = new Handler();
+    bus.addEventHandler("#", handler, &Handler::increaseCounter);
+    counter = 0;
+    bus.publish(topic, 1);
+    if (counter != 112 || topic.name() != "md.nyse.AAPL.trade" || topic != bus.topic("md.nyse.AAPL.trade")) {
+        return 1;
+    }
+
+    // Destroyed objects are removed, erased and cleared patterns are gone
+    delete handler;
+    bus.erase("md.*.AAPL.#");
+    counter = 0;
+    bus.publish(topic, 1);
+    if (counter != 101) {
+        return 1;
+    }
+    bus.clear();
+    bus.publish(topic, 1);
+    if (counter != 101 || !topic.isValid()) {
+        return 1;
+    }
+
+    // Handlers subscribing and unsubscribing during the publication
+    Connection connection = bus.addEventHandler("a.b", [&bus] (int) {
+        bus.addEventHandler("a.#", [] (int value) { counter += value; });
+        bus.erase("a.b");
+    });
+    counter = 0;
+    bus.publish("a.b", 1);
+    bus.publish("a.b", 1);
+    if (counter != 1) {
+        return 1;
+    }
+    bus.addEventHandler("a.b", [] (int value) { counter += value; });
+    connection = bus.addEventHandler("a.b", [] (int value) { counter += 10 * value; });
+    bus.removeEventHandler("a.b", connection);
+    counter = 0;
+    bus.publish("a.b", 1);
+    if (counter != 2) {
+        return 1;
+    }
+
+    // Erasing the last patterns removes their trie nodes
+    bus.clear();
+    bus.addEventHandler("x.*.y", [] (int) { });
+    bus.addEventHandler("x.#", [] (int) { });
+    bus.erase("x.*.y");
+    bus.erase("x.*.z");
+    if (bus.empty()) {
+        return 1;
+    }
+    bus.erase("x.#");
+    if (!bus.empty()) {
+        return 1;
+    }
+
+    // Topics published by name are cached up to the capacity, interned ones are kept
+    EventBus<int> orders(16);
+    orders.addEventHandler("order.*", [] (int value) { counter += value; });
+    EventBus<int>::Topic interned = orders.topic("order.0");
+    counter = 0;
+    for (int i = 0; i < 1000; ++i) {
+        orders.publish("order." + std::to_string(i), 1);
+        if (orders.cachedTopics() > 16) {
+            return 1;
+        }
+    }
+    orders.publish(interned, 1);
+    if (counter != 1001 || interned.name() != "order.0" || EventBus<int>::Topic().isValid()) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <hlk/events/concurrentevent.h>
+#include <hlk/events/event.h>
+#include <hlk/events/eventloop.h>
+
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+class Receiver : public NotifiableObject {
+public:
+    Receiver(EventLoop *loop) {
+        setEventLoop(loop);
+    }
+
+    void onValue(int value) {
+        values.push_back(value);
+        ownThread = ownThread && eventLoop()->isInLoopThread();
+    }
+
+    std::vector<int> values;
+    bool ownThread = true;
+};
+
+// Waits until the loop processed everything posted before
+void sync(EventLoop &loop) {
+    std::promise<void> done;
+    loop.post([&done] () { done.set_value(); });
+    done.get_future().wait();
+}
+
+int main(int argc, char *argv[]) {
+    // Calls from other threads run on the loop thread in FIFO order
+    EventLoop loop;
+    loop.start();
+    Receiver receiver(&loop);
+    Event<int> event;
+    event.addEventHandler(&receiver, &Receiver::onValue);
+    for (int i = 0; i < 1000; ++i) {
+        event(i);
+    }
+    sync(loop);
+    if (receiver.values.size() != 1000 || !receiver.ownThread) {
+        return 1;
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (receiver.values[i] != i) {
+            return 1;
+        }
+    }
+
+    // Emission on the loop thread is a direct call
+    bool direct = false;
+    loop.post([&] () {
+        receiver.values.clear();
+        event(7);
+        direct = receiver.values.size() == 1;
+    });
+    sync(loop);
+    if (!direct) {
+        return 1;
+    }
+
+    // Removal by value finds the queued handler
+    event.removeEventHandler(&receiver, &Receiver::onValue);
+    event(8);
+    sync(loop);
+    if (receiver.values.size() != 1) {
+        return 1;
+    }
+    loop.quit();
+    loop.wait();
+
+    // Loop processed by the calling thread, lambdas follow their context
+    EventLoop manualLoop;
+    auto manualReceiver = std::make_unique<Receiver>(&manualLoop);
+    ConcurrentEvent<int> concurrentEvent;
+    concurrentEvent.addEventHandler(manualReceiver.get(), &Receiver::onValue);
+    int contextCalls = 0;
+    concurrentEvent.addEventHandler(manualReceiver.get(), [&contextCalls] (int value) { ++contextCalls; });
+    std::thread emitter([&concurrentEvent] () {
+        concurrentEvent(1);
+        concurrentEvent(2);
+    });
+    emitter.join();
+    if (!manualReceiver->values.empty() || contextCalls != 0) {
+        return 1;
+    }
+    if (manualLoop.processEvents() != 4 || manualReceiver->values != std::vector<int> { 1, 2 }
+        || contextCalls != 2 || !manualReceiver->ownThread) {
+        return 1;
+    }
+
+    // Calls queued to a destroyed object are dropped
+    std::thread([&concurrentEvent] () { concurrentEvent(3); }).join();
+    manualReceiver.reset();
+    if (manualLoop.processEvents() != 2 || contextCalls != 2) {
+        return 1;
+    }
+
+    // Copies take the loop of the original, assignment keeps the own loop
+    Receiver bound(&loop);
+    Receiver unbound(nullptr);
+    Receiver copy(bound);
+    unbound = bound;
+    if (copy.eventLoop() != &loop || unbound.eventLoop() != nullptr) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <hlk/events/event.h>
+#include <hlk/events/eventqueue.h>
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+std::vector<int> received;
+
+// Posts 1..6 to a queue of capacity 4 and processes it
+bool overflow(EventQueue::OverflowPolicy policy, const std::vector<int> &expected,
+    size_t dropped, size_t overwritten) {
+    EventQueue queue(4, policy);
+    Event<int> event;
+    event.addEventHandler([] (int value) { received.push_back(value); });
+    received.clear();
+    for (int i = 1; i <= 6; ++i) {
+        bool posted = queue.post(event, i);
+        if (posted != (policy != EventQueue::OverflowPolicy::DropNewest || i <= 4)) {
+            return false;
+        }
+    }
+    queue.processEvents();
+    return received == expected && queue.droppedCount() == dropped
+        && queue.overwrittenCount() == overwritten && queue.highWaterMark() == 4;
+}
+
+int main(int argc, char *argv[]) {
+    // Handlers are called by the consumer in the posting order
+    EventQueue queue(8);
+    Event<int> event;
+    event.addEventHandler([] (int value) { received.push_back(value); });
+    queue.post(event, 1);
+    queue.post(event, 2);
+    queue.post(event, 3);
+    if (!received.empty() || queue.size() != 3) {
+        return 1;
+    }
+    if (queue.processEvents(2) != 2 || received != std::vector<int> { 1, 2 }) {
+        return 1;
+    }
+    if (queue.processEvents() != 1 || received.back() != 3 || queue.size() != 0) {
+        return 1;
+    }
+    if (queue.highWaterMark() != 3) {
+        return 1;
+    }
+
+    // Overflow policies
+    using Policy = EventQueue::OverflowPolicy;
+    if (!overflow(Policy::DropNewest, { 1, 2, 3, 4 }, 2, 0)) {
+        return 1;
+    }
+    if (!overflow(Policy::DropOldest, { 3, 4, 5, 6 }, 2, 0)) {
+        return 1;
+    }
+    if (!overflow(Policy::Overwrite, { 3, 4, 5, 6 }, 0, 2)) {
+        return 1;
+    }
+
+    // Emissions of a destroyed event are dropped
+    received.clear();
+    auto temporary = std::make_unique<Event<int>>();
+    temporary->addEventHandler([] (int value) { received.push_back(value); });
+    queue.post(*temporary, 1);
+    temporary.reset();
+    if (queue.processEvents() != 1 || !received.empty()) {
+        return 1;
+    }
+
+    // Move-only arguments and emissions larger than a slot
+    unsigned int sum = 0;
+    Event<std::unique_ptr<int>> ownershipEvent;
+    ownershipEvent.addEventHandler([&sum] (std::unique_ptr<int> value) { sum += *value; });
+    Event<std::array<unsigned int, 64>> largeEvent;
+    largeEvent.addEventHandler([&sum] (std::array<unsigned int, 64> values) { sum += values[63]; });
+    std::array<unsigned int, 64> values {};
+    values[63] = 10;
+    queue.post(ownershipEvent, std::make_unique<int>(1));
+    queue.post(largeEvent, values);
+    if (queue.processEvents() != 2 || sum != 11) {
+        return 1;
+    }
+
+    // Asynchronous emissions use the queue as an executor
+    received.clear();
+    event.setExecutor(&queue);
+    event.emitAsync(5);
+    if (!received.empty() || queue.processEvents() != 1 || received.back() != 5) {
+        return 1;
+    }
+    event.setExecutor(nullptr);
+
+    // Blocking producers keep their own order
+    constexpr int producers = 4;
+    constexpr int posts = 10000;
+    EventQueue blockingQueue(16);
+    Event<int, int> producerEvent;
+    std::array<int, producers> last;
+    last.fill(-1);
+    bool ordered = true;
+    producerEvent.addEventHandler([&last, &ordered] (int producer, int value) {
+        ordered = ordered && value == last[producer] + 1;
+        last[producer] = value;
+    });
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&blockingQueue, &producerEvent, producer] () {
+            for (int i = 0; i < posts; ++i) {
+                blockingQueue.post(producerEvent, producer, i);
+            }
+        });
+    }
+    size_t processed = 0;
+    while (processed < producers * posts) {
+        size_t count = blockingQueue.processEvents();
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        processed += count;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (!ordered || blockingQueue.droppedCount() != 0 || blockingQueue.highWaterMark() > 16) {
+        return 1;
+    }
+
+    return 0;
+}
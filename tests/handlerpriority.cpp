@@ -0,0 +1,109 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <string>
+
+using namespace Hlk;
+
+std::string order;
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+int main(int argc, char *argv[]) {
+    Event<> event;
+
+    // Higher priority first, equal priorities in the order of attaching
+    event.addEventHandler([] () { order += 'c'; });
+    event.addEventHandler([] () { order += 'e'; }, -10);
+    event.addEventHandler([] () { order += 'a'; }, 10);
+    event.addEventHandler([] () { order += 'd'; });
+    event.addEventHandler([] () { order += 'b'; }, 10);
+    event();
+    if (order != "abcde") {
+        return 1;
+    }
+
+    // Handler with priority attached during emission is sorted when it ends
+    Connection nested = event.addEventHandler([&event, &nested] () {
+        order += 'x';
+        event.removeEventHandler(nested);
+        event.addEventHandler([] () { order += '0'; }, 100);
+    }, 5);
+    order.clear();
+    event();
+    event();
+    if (order != "abxcde0abcde") {
+        return 1;
+    }
+
+    // Once handler is removed before its call, even by a nested emission
+    Event<> once;
+    once.addEventHandler([&once] () {
+        ++counter;
+        once();
+    }, 0, true);
+    once();
+    once();
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Once method handler is detached from its object
+    auto handler = new Handler();
+    once.addEventHandler(handler, &Handler::increaseCounter, 0, true);
+    once();
+    delete handler;
+    once();
+    if (counter != 2) {
+        return 1;
+    }
+
+    // Copies keep priorities and once flags
+    Event<> source;
+    source.addEventHandler([] () { order += 'b'; });
+    source.addEventHandler([] () { order += 'a'; }, 1, true);
+    Event<> copy(source);
+    order.clear();
+    copy();
+    copy();
+    if (order != "abb") {
+        return 1;
+    }
+
+    // Many handlers, the hash index doesn't affect the order
+    Event<int> many;
+    int last = 100;
+    bool sorted = true;
+    for (int i = 0; i < 64; ++i) {
+        many.addEventHandler([i, &last, &sorted] (int) {
+            sorted = sorted && i % 8 <= last;
+            last = i % 8;
+        }, i % 8);
+    }
+    many(0);
+    if (!sorted || last != 0) {
+        return 1;
+    }
+
+    // Handlers attached or removed before the next emission are merged into the sorted ones
+    Event<> merged;
+    merged.addEventHandler([] () { order += 'c'; });
+    merged.addEventHandler([] () { order += 'a'; }, 2);
+    order.clear();
+    merged();
+    Connection removed = merged.addEventHandler([] () { order += 'x'; }, 3);
+    merged.addEventHandler([] () { order += 'b'; }, 1);
+    merged.addEventHandler([] () { order += 'd'; });
+    merged.addEventHandler([] () { order += 'e'; }, 2);
+    merged.removeEventHandler(removed);
+    merged();
+    if (order != "acaebcd") {
+        return 1;
+    }
+
+    return 0;
+}
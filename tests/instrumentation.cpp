@@ -0,0 +1,109 @@
+#include <hlk/events/event.h>
+#include <hlk/events/instrumentation.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace Hlk;
+using namespace std::chrono;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+const Instrumentation::EventSnapshot *find(const Instrumentation::Snapshot &snapshot, const AbstractEvent *event) {
+    for (const Instrumentation::EventSnapshot &stats : snapshot.events) {
+        if (stats.event == event) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+int main(int argc, char *argv[]) {
+    // Every value falls into a bucket at most 12.5% wider than its lower bound
+    for (uint64_t value = 0; value < (uint64_t(1) << 34); value = value * 9 / 8 + 1) {
+        unsigned int bucket = LatencyHistogram::bucketOf(value);
+        uint64_t lower = LatencyHistogram::bucketLowerBound(bucket);
+        uint64_t upper = LatencyHistogram::bucketLowerBound(bucket + 1);
+        if (lower > value || upper <= value || (upper - lower) * 8 > std::max<uint64_t>(lower, 8)) {
+            return 1;
+        }
+    }
+
+    auto histogram = std::make_unique<LatencyHistogram>();
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram->record(value);
+    }
+    LatencyHistogram::Snapshot values = histogram->snapshot();
+    uint64_t median = values.percentile(50);
+    if (values.count != 1000 || values.max != 1000 || values.mean() != 500.5 
+        || median < 500 || median > 500 * 9 / 8 || values.percentile(100) != 1000) {
+        return 1;
+    }
+
+    Event<> event;
+    auto handler = new Handler();
+    event.addEventHandler(handler, &Handler::increaseCounter);
+    event.addEventHandler([] () { std::this_thread::sleep_for(milliseconds(2)); });
+    event.addEventHandler([] () { ++counter; });
+    for (int i = 0; i < 10; ++i) {
+        event();
+    }
+
+    Instrumentation::Snapshot snapshot = Instrumentation::snapshot();
+    if constexpr (!Instrumentation::enabled) {
+        // Nothing is recorded without instrumentation
+        delete handler;
+        return snapshot.events.empty() && snapshot.attachments == 0 ? 0 : 1;
+    }
+
+    // Emissions, handlers and their calls of the event
+    const Instrumentation::EventSnapshot *stats = find(snapshot, &event);
+    if (stats == nullptr || stats->emissions != 10 || stats->handlers != 3 
+        || stats->handlerLatency.count != 30 || stats->handlerLatency.max < 2000000 
+        || stats->handlerLatency.percentile(50) >= 2000000 || snapshot.attachments != 1) {
+        return 1;
+    }
+    if (snapshot.toString().find("emissions 10") == std::string::npos) {
+        return 1;
+    }
+
+    // Stats follow a moved event and leave with a destroyed one
+    Event<> moved(std::move(event));
+    moved();
+    snapshot = Instrumentation::snapshot();
+    stats = find(snapshot, &moved);
+    if (stats == nullptr || stats->emissions != 11) {
+        return 1;
+    }
+    delete handler;
+    if (Instrumentation::snapshot().attachments != 0) {
+        return 1;
+    }
+
+    {
+        Event<> temporary;
+        temporary.addEventHandler([] () { });
+        if (find(Instrumentation::snapshot(), &temporary) == nullptr) {
+            return 1;
+        }
+    }
+    size_t events = Instrumentation::snapshot().events.size();
+
+    // Reset counters
+    Instrumentation::reset();
+    snapshot = Instrumentation::snapshot();
+    stats = find(snapshot, &moved);
+    if (snapshot.events.size() != events || stats == nullptr || stats->emissions != 0 
+        || stats->handlerLatency.count != 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <hlk/events/keyedevent.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter(int value) { counter += value; }
+};
+
+void addTen(int) { counter += 10; }
+
+int main(int argc, char *argv[]) {
+    // Only the handlers of the emitted key are called
+    KeyedEvent<std::string, int> event;
+    std::vector<std::unique_ptr<Handler>> handlers;
+    for (int i = 0; i < 1000; ++i) {
+        handlers.push_back(std::make_unique<Handler>());
+        event.addEventHandler(std::to_string(i % 100), handlers.back().get(), &Handler::increaseCounter);
+    }
+    event.emit("7", 1);
+    if (counter != 10) {
+        return 1;
+    }
+    event("unknown", 1);
+    if (counter != 10 || event.size() != 100) {
+        return 1;
+    }
+
+    // Destroyed objects are removed from their keys
+    handlers.erase(handlers.begin(), handlers.begin() + 500);
+    counter = 0;
+    event("7", 1);
+    if (counter != 5) {
+        return 1;
+    }
+
+    // Functions and lambdas with priorities, removal by value and connection
+    KeyedEvent<int, int> keyed;
+    keyed.addEventHandler(1, addTen);
+    Connection connection = keyed.addEventHandler(1, [] (int value) { counter *= value; }, 1);
+    keyed.addEventHandler(2, addTen);
+    counter = 1;
+    keyed(1, 3);
+    if (counter != 13) {
+        return 1;
+    }
+    keyed.removeEventHandler(1, connection);
+    keyed.removeEventHandler(2, addTen);
+    counter = 0;
+    keyed(1, 3);
+    keyed(2, 3);
+    if (counter != 10 || keyed.size() != 1) {
+        return 1;
+    }
+
+    // Keys emptied by destroyed objects are dropped by prune()
+    auto object = std::make_unique<Handler>();
+    keyed.addEventHandler(5, object.get(), &Handler::increaseCounter);
+    object.reset();
+    if (keyed.size() != 2) {
+        return 1;
+    }
+    keyed.prune();
+    if (keyed.size() != 1) {
+        return 1;
+    }
+
+    // Handler erasing its own key and subscribing to another one
+    keyed.addEventHandler(3, [&keyed] (int) {
+        keyed.erase(3);
+        keyed.addEventHandler(4, addTen);
+        ++counter;
+    });
+    counter = 0;
+    keyed(3, 0);
+    keyed(3, 0);
+    keyed(4, 0);
+    if (counter != 11) {
+        return 1;
+    }
+
+    keyed.clear();
+    keyed(1, 0);
+    if (counter != 11 || keyed.size() != 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Hlk;
+
+std::atomic<unsigned int> counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+static_assert(sizeof(Event<int>) <= 2 * sizeof(void *), "An empty Event is a vtable and a state pointer");
+
+int main(int argc, char *argv[]) {
+    // Never subscribed events are emitted, copied, moved and cleared
+    Event<> empty;
+    empty();
+    empty.removeEventHandler(Connection());
+    empty.clear();
+    Event<> copy(empty);
+    Event<> moved(std::move(copy));
+    moved = empty;
+    moved();
+    if (counter != 0) {
+        return 1;
+    }
+
+    // Threads racing for the first subscription share one state
+    constexpr unsigned int threadCount = 4;
+    for (int round = 0; round < 50; ++round) {
+        Event<> event;
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&event, i] () {
+                event.addEventHandler([i] () { counter += i + 1; });
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        counter = 0;
+        event();
+        if (counter != 10) {
+            return 1;
+        }
+    }
+
+    // Attachments follow the state of a moved event
+    auto handler = new Handler();
+    Event<> source;
+    source.addEventHandler(handler, &Handler::increaseCounter);
+    Event<> target(std::move(source));
+    counter = 0;
+    source();
+    target();
+    delete handler;
+    target();
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Assignment to a never subscribed event
+    Event<> assigned;
+    assigned = target;
+    target.addEventHandler([] () { ++counter; });
+    assigned = target;
+    counter = 0;
+    assigned();
+    if (counter != 1) {
+        return 1;
+    }
+
+    return 0;
+}
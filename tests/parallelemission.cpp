@@ -0,0 +1,66 @@
+#include <hlk/events/event.h>
+#include <hlk/events/threadpool.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Hlk;
+using namespace std::chrono;
+
+std::atomic<unsigned int> counter = 0;
+
+int main(int argc, char *argv[]) {
+    ThreadPool pool(4);
+
+    // Sleeping handlers overlap, the emission waits for all of them
+    Event<int> event;
+    event.setExecutor(&pool);
+    for (int i = 0; i < 10; ++i) {
+        event.addEventHandler([i] (int value) {
+            std::this_thread::sleep_for(milliseconds(20));
+            counter += value + i;
+        });
+    }
+    auto start = steady_clock::now();
+    event.emitParallel(1);
+    auto elapsed = steady_clock::now() - start;
+    if (counter != 55 || elapsed >= milliseconds(150)) {
+        return 1;
+    }
+
+    // Once handlers are called by one parallel emission only
+    Event<> once;
+    once.setExecutor(&pool);
+    once.addEventHandler([] () { counter += 100; }, 0, true);
+    once.addEventHandler([] () { ++counter; });
+    counter = 0;
+    once.emitParallel();
+    once.emitParallel();
+    if (counter != 102) {
+        return 1;
+    }
+
+    // Nested parallel emissions from the workers of a saturated pool
+    Event<> inner;
+    inner.setExecutor(&pool);
+    for (int i = 0; i < 8; ++i) {
+        inner.addEventHandler([i] () { counter += i; });
+    }
+    Event<> outer;
+    outer.setExecutor(&pool);
+    for (size_t i = 0; i < 8; ++i) {
+        outer.addEventHandler([&inner, i] () { inner.emitParallel(); });
+    }
+    counter = 0;
+    outer.emitParallel();
+    if (counter != 8 * 28) {
+        return 1;
+    }
+
+    // Never subscribed event
+    Event<> empty;
+    empty.emitParallel();
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+
+#include <array>
+#include <memory>
+
+using namespace Hlk;
+
+unsigned int calls = 0;
+
+int twice(int value) { ++calls; return value * 2; }
+
+class Validator : public NotifiableObject {
+public:
+    Validator(int limit) : m_limit(limit) { }
+
+    bool accepts(int value) { ++calls; return value <= m_limit; }
+
+protected:
+    int m_limit;
+};
+
+int main(int argc, char *argv[]) {
+    // Default emission returns the result of the last handler
+    Event<int(int)> event;
+    if (event(1).has_value()) {
+        return 1;
+    }
+    event.addEventHandler(twice);
+    event.addEventHandler([] (int value) { ++calls; return value * 3; });
+    if (event(5) != 15 || calls != 2) {
+        return 1;
+    }
+
+    // First result stops the emission
+    calls = 0;
+    if (event.emit(FirstResult<int>(), 5) != 10 || calls != 1) {
+        return 1;
+    }
+
+    // All results into a preallocated buffer, stopping once it is full
+    std::array<int, 4> buffer {};
+    calls = 0;
+    if (event.emit(AllResults<int>(buffer), 2) != 2 || buffer[0] != 4 || buffer[1] != 6) {
+        return 1;
+    }
+    std::array<int, 1> small {};
+    calls = 0;
+    if (event.emit(AllResults<int>(small), 2) != 1 || small[0] != 4 || calls != 1) {
+        return 1;
+    }
+
+    // Veto-style checks short-circuit
+    Event<bool(int)> onAdmission;
+    auto strict = std::make_unique<Validator>(10);
+    Validator loose(100);
+    onAdmission.addEventHandler(strict.get(), &Validator::accepts);
+    onAdmission.addEventHandler(&loose, &Validator::accepts);
+    calls = 0;
+    if (onAdmission.emit(AllOf(), 50) || calls != 1) {
+        return 1;
+    }
+    calls = 0;
+    if (!onAdmission.emit(AnyOf(), 50) || calls != 2) {
+        return 1;
+    }
+    calls = 0;
+    if (!onAdmission.emit(AllOf(), 5) || calls != 2) {
+        return 1;
+    }
+
+    // Handlers of destroyed objects are removed
+    strict.reset();
+    calls = 0;
+    if (!onAdmission.emit(AllOf(), 50) || calls != 1) {
+        return 1;
+    }
+    onAdmission.removeEventHandler(&loose, &Validator::accepts);
+    if (!onAdmission.emit(AllOf(), 500) || onAdmission.emit(AnyOf(), 500)) {
+        return 1;
+    }
+
+    return 0;
+}
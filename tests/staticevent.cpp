@@ -0,0 +1,63 @@
+#include <hlk/events/event.h>
+#include <hlk/events/staticevent.h>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+void increaseCounter(int value) { counter += value; }
+void multiplyCounter(int value) { counter *= value; }
+
+Event<int> globalEvent;
+
+class Pipeline {
+public:
+    void decode(int value) { counter += value * 10; }
+
+    Event<int> onDecoded;
+};
+
+void decodeTwice(Pipeline *pipeline, int value) {
+    pipeline->decode(value);
+    pipeline->decode(value);
+}
+
+int main(int argc, char *argv[]) {
+    // Functions are called in the order of declaration
+    StaticEvent<&increaseCounter, &multiplyCounter> functions;
+    functions(2);
+    if (counter != 4 || functions.size() != 2 || !std::is_empty_v<decltype(functions)>) {
+        return 1;
+    }
+
+    // Methods, member events and functions taking the object
+    Pipeline pipeline;
+    pipeline.onDecoded.addEventHandler(increaseCounter);
+    counter = 0;
+    StaticEvent<&Pipeline::decode, &Pipeline::onDecoded, &decodeTwice>::emit(&pipeline, 1);
+    if (counter != 31) {
+        return 1;
+    }
+
+    // Forwarding to a global dynamic event
+    globalEvent.addEventHandler(multiplyCounter);
+    counter = 1;
+    StaticEvent<&increaseCounter, &globalEvent>::emit(2);
+    if (counter != 6) {
+        return 1;
+    }
+
+    // Static event attached to a dynamic one, duplicates are detected
+    Event<int> event;
+    Connection connection = event.addEventHandler(functions);
+    if (event.addEventHandler(StaticEvent<&increaseCounter, &multiplyCounter>()) != connection) {
+        return 1;
+    }
+    counter = 0;
+    event(3);
+    if (counter != 9) {
+        return 1;
+    }
+
+    return 0;
+}
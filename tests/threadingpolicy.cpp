@@ -0,0 +1,129 @@
+#include <hlk/events/collectors.h>
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+#include <hlk/events/threadingpolicy.h>
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+static_assert(std::is_base_of_v<Event<MultiThreaded, int>, Event<int>>, "Event<int> is the multithreaded event");
+
+// Handlers attached and emitted by several threads at once
+template<class TPolicy>
+bool concurrentEmission() {
+    constexpr unsigned int threadCount = 4;
+    constexpr unsigned int rounds = 2000;
+    std::atomic<unsigned int> calls = 0;
+    Event<TPolicy, int> event;
+    event.addEventHandler([&calls] (int value) { calls += value; });
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&event, &calls] () {
+            for (unsigned int round = 0; round < rounds; ++round) {
+                Connection connection = event.addEventHandler([&calls] (int) { ++calls; });
+                event(1);
+                event.removeEventHandler(connection);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // Temporary handlers are all gone
+    calls = 0;
+    event(1);
+    return calls == 1;
+}
+
+template<class TMutex>
+bool exclusiveLock() {
+    TMutex mutex;
+    unsigned int value = 0;
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < 4; ++i) {
+        threads.emplace_back([&mutex, &value] () {
+            for (unsigned int j = 0; j < 10000; ++j) {
+                std::unique_lock lock(mutex);
+                ++value;
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    if (!mutex.try_lock()) {
+        return false;
+    }
+    bool locked = !mutex.try_lock();
+    mutex.unlock();
+    return locked && value == 40000;
+}
+
+int main(int argc, char *argv[]) {
+    // Single-threaded event still removes handlers of destroyed objects
+    auto handler = new Handler();
+    Event<SingleThreaded> event;
+    event.addEventHandler(handler, &Handler::increaseCounter);
+    event.addEventHandler([] () { counter += 10; });
+    event();
+    delete handler;
+    event();
+    if (counter != 21) {
+        return 1;
+    }
+
+    // Untracked event, the object removes its handler itself
+    handler = new Handler();
+    Event<SingleThreadedUntracked> untracked;
+    Connection connection = untracked.addEventHandler(handler, &Handler::increaseCounter);
+    counter = 0;
+    untracked();
+    untracked.removeEventHandler(connection);
+    delete handler;
+    untracked();
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Copies and moves keep the policy
+    Event<SingleThreaded> copy(event);
+    Event<SingleThreaded> moved(std::move(copy));
+    counter = 0;
+    moved();
+    if (counter != 10) {
+        return 1;
+    }
+
+    // Events with results take a policy as well
+    Event<SingleThreaded, int(int)> square;
+    square.addEventHandler([] (int value) { return value * value; });
+    square.addEventHandler([] (int value) { return value + 1; });
+    if (square.emit(LastResult<int>(), 4) != 5) {
+        return 1;
+    }
+
+    if (!concurrentEmission<SpinLocked>() || !concurrentEmission<FutexLocked>()
+        || !concurrentEmission<MultiThreaded>()) {
+        return 1;
+    }
+
+    if (!exclusiveLock<SpinMutex>() || !exclusiveLock<FutexMutex>()) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <hlk/events/event.h>
+#include <hlk/events/notifiableobject.h>
+#include <hlk/events/tracer.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+
+class Handler : public NotifiableObject {
+public:
+    void increaseCounter() { ++counter; }
+};
+
+std::string read(const char *path) {
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+bool contains(const std::string &string, const std::string &part) {
+    return string.find(part) != std::string::npos;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = "tracing.json";
+    Tracer::start();
+
+    // Cascade: a handler emits an event whose handler destroys a notifiable
+    Event<> clicked;
+    clicked.setName("clicked");
+    Event<int> changed;
+    changed.setName("value \"changed\"");
+    Event<> unnamed;
+    auto handler = new Handler();
+    unnamed.addEventHandler(handler, &Handler::increaseCounter);
+    changed.addEventHandler([&handler] (int) {
+        delete handler;
+        handler = nullptr;
+    });
+    clicked.addEventHandler([&changed] () { changed(1); });
+    clicked();
+    std::thread([&clicked] () { clicked(); }).join();
+
+    bool written = Tracer::write(path);
+    if constexpr (!Instrumentation::enabled) {
+        // Nothing is recorded without instrumentation
+        return !written && *clicked.name() == '\0' ? 0 : 1;
+    }
+
+    std::string trace = read(path);
+    if (!written || std::string(clicked.name()) != "clicked" 
+        || trace.rfind("{\"traceEvents\":[", 0) != 0 
+        || !contains(trace, "\"name\":\"clicked\",\"cat\":\"emission\",\"ph\":\"X\"") 
+        || !contains(trace, "\"name\":\"clicked handler\",\"cat\":\"handler\"") 
+        || !contains(trace, "\"name\":\"value \\\"changed\\\"\",\"cat\":\"emission\"") 
+        || !contains(trace, "\"name\":\"attach\"") 
+        || !contains(trace, "\"name\":\"detach\"") 
+        || !contains(trace, "\"name\":\"notifiable destroyed\"") 
+        || !contains(trace, "\"tid\":2") 
+        || !contains(trace, "\"dropped\":0}}")) {
+        return 1;
+    }
+
+    // Nothing is recorded after the tracer stops, start() discards the records
+    clicked();
+    Tracer::write(path);
+    if (read(path) != trace) {
+        return 1;
+    }
+    Tracer::start();
+    Tracer::write(path);
+    if (contains(read(path), "\"cat\"")) {
+        return 1;
+    }
+
+    // Records over the capacity are dropped
+    Tracer::start(4);
+    for (int i = 0; i < 10; ++i) {
+        clicked();
+    }
+    Tracer::write(path);
+    if (!contains(read(path), "\"dropped\":36}}")) {
+        return 1;
+    }
+
+    // A moved event keeps its name
+    Event<> moved(std::move(clicked));
+    if (std::string(moved.name()) != "clicked") {
+        return 1;
+    }
+
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <hlk/events/event.h>
+
+#include <memory>
+
+using namespace Hlk;
+
+unsigned int counter = 0;
+unsigned int deallocations = 0;
+
+class Handler {
+public:
+    ~Handler() { alive = false; }
+
+    void increaseCounter() { ++counter; }
+    int square(int value) { return value * value; }
+
+    // Releases the last owner, the object lives until the call returns
+    void release() {
+        owner.reset();
+        counter += alive;
+    }
+
+    std::shared_ptr<Handler> owner;
+    bool alive = true;
+};
+
+// Counts freed control blocks, they outlive the objects while weak references remain
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template<class U>
+    CountingAllocator(const CountingAllocator<U> &) { }
+
+    T *allocate(std::size_t count) { return std::allocator<T>().allocate(count); }
+
+    void deallocate(T *pointer, std::size_t count) {
+        ++deallocations;
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template<class U>
+    bool operator==(const CountingAllocator<U> &) const { return true; }
+
+    template<class U>
+    bool operator!=(const CountingAllocator<U> &) const { return false; }
+};
+
+int main(int argc, char *argv[]) {
+    // Called while the object lives, the same object is attached once
+    auto object = std::allocate_shared<Handler>(CountingAllocator<Handler>());
+    Event<> event;
+    Connection connection = event.addEventHandler(std::weak_ptr<Handler>(object), &Handler::increaseCounter);
+    if (event.addEventHandler(object, &Handler::increaseCounter) != connection) {
+        return 1;
+    }
+    Event<> copy(event);
+    event();
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Expired handlers are skipped and pruned by the next emission of each event
+    object.reset();
+    event();
+    if (counter != 1 || deallocations != 0) {
+        return 1;
+    }
+    copy();
+    if (counter != 1 || deallocations != 1) {
+        return 1;
+    }
+
+    // Removal by the weak reference
+    object = std::make_shared<Handler>();
+    event.addEventHandler(object, &Handler::increaseCounter);
+    event.removeEventHandler(std::weak_ptr<Handler>(object), &Handler::increaseCounter);
+    event();
+    if (counter != 1) {
+        return 1;
+    }
+
+    // Handler releasing the last reference to its object
+    object->owner = object;
+    event.addEventHandler(object, &Handler::release);
+    std::weak_ptr<Handler> weak = object;
+    object.reset();
+    event();
+    if (counter != 2 || !weak.expired()) {
+        return 1;
+    }
+
+    // Events with results skip expired handlers as well
+    auto calculator = std::make_shared<Handler>();
+    Event<int(int)> square;
+    square.addEventHandler([] (int value) { return value; });
+    square.addEventHandler(calculator, &Handler::square);
+    if (square(3) != 9) {
+        return 1;
+    }
+    calculator.reset();
+    if (square(3) != 3) {
+        return 1;
+    }
+
+    return 0;
+}